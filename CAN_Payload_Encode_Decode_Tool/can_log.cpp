@@ -0,0 +1,201 @@
+/*
+ *  can_log.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "can_log.hpp"
+
+namespace {
+
+    inline int hexDigitValue(char c) {
+        if (c >= '0' && c <= '9') { return c - '0'; }
+        if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+        if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+        return -1;
+    }
+
+    // First read after a seek, room for a few dozen frames
+    constexpr size_t SEEK_READ_SIZE = 4096;
+
+    inline const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            p++;
+        }
+        return p;
+    }
+
+}
+
+bool parseCandumpLine(const char* begin, const char* end, CanFrame& frame) {
+    const char* p = skipSpaces(begin, end);
+    // Timestamp: "(seconds.fraction)"
+    if (p == end || *p != '(') {
+        return false;
+    }
+    p++;
+    uint64_t seconds = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        seconds = seconds * 10 + (*p - '0');
+        p++;
+    }
+    uint64_t micros = 0;
+    if (p < end && *p == '.') {
+        p++;
+        unsigned int digits = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            // Anything below one microsecond is dropped
+            if (digits < 6) {
+                micros = micros * 10 + (*p - '0');
+                digits++;
+            }
+            p++;
+        }
+        for (; digits < 6; digits++) {
+            micros *= 10;
+        }
+    }
+    if (p == end || *p != ')') {
+        return false;
+    }
+    frame.timestamp = seconds * 1000000 + micros;
+    p = skipSpaces(p + 1, end);
+    // Interface name, the trailing number is used as channel
+    const char* nameBegin = p;
+    while (p < end && *p != ' ' && *p != '\t') {
+        p++;
+    }
+    if (p == nameBegin) {
+        return false;
+    }
+    frame.channel = channelFromInterfaceName(nameBegin, p);
+    p = skipSpaces(p, end);
+    // CAN ID
+    unsigned long id = 0;
+    unsigned int idDigits = 0;
+    int digit;
+    while (p < end && (digit = hexDigitValue(*p)) >= 0) {
+        id = (id << 4) | digit;
+        idDigits++;
+        p++;
+    }
+    if (idDigits == 0 || p == end || *p != '#') {
+        return false;
+    }
+    p++;
+    frame.id = idDigits > 3 ? (id | CAN_ID_EXTENDED_FLAG) : id;
+    frame.size = 0;
+    // Remote frames carry no data
+    if (p < end && *p == 'R') {
+        return true;
+    }
+    // CAN FD frames use "##" followed by one flags digit
+    if (p < end && *p == '#') {
+        p += 2;
+        if (p > end) {
+            return false;
+        }
+    }
+    while (p + 1 < end && frame.size < MAX_MSG_LEN_CAN_FD) {
+        int high = hexDigitValue(p[0]);
+        int low = hexDigitValue(p[1]);
+        if (high < 0 || low < 0) {
+            break;
+        }
+        frame.payload[frame.size++] = static_cast<unsigned char>((high << 4) | low);
+        p += 2;
+    }
+    return true;
+}
+
+unsigned int channelFromInterfaceName(const char* begin, const char* end) {
+    const char* digitsBegin = end;
+    while (digitsBegin > begin && digitsBegin[-1] >= '0' && digitsBegin[-1] <= '9') {
+        digitsBegin--;
+    }
+    unsigned int channel = 0;
+    for (const char* d = digitsBegin; d < end; d++) {
+        channel = channel * 10 + (*d - '0');
+    }
+    return channel;
+}
+
+CanLogReader::CanLogReader(const std::string& logPath, size_t bufferSize) :
+    file(logPath.c_str(), std::ios::binary), buffer(bufferSize), readSize(bufferSize) {
+    if (!file) {
+        throw std::invalid_argument("Could not open CAN log file \"" + logPath + "\".");
+    }
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+}
+
+bool CanLogReader::refill() {
+    if (endOfFile) {
+        return false;
+    }
+    // Keep the partial line that is left in the buffer
+    size_t remaining = bufferEnd - bufferPos;
+    if (remaining == buffer.size()) {
+        // A single line does not fit, grow the buffer
+        buffer.resize(buffer.size() * 2);
+    }
+    std::memmove(buffer.data(), buffer.data() + bufferPos, remaining);
+    bufferFileOffset += bufferPos;
+    bufferPos = 0;
+    bufferEnd = remaining;
+    size_t readLength = std::min(readSize, buffer.size() - bufferEnd);
+    readSize = std::min(readSize * 2, buffer.size());
+    file.read(buffer.data() + bufferEnd, static_cast<std::streamsize>(readLength));
+    std::streamsize bytesRead = file.gcount();
+    if (bytesRead <= 0) {
+        endOfFile = true;
+        return false;
+    }
+    bufferEnd += static_cast<size_t>(bytesRead);
+    return true;
+}
+
+bool CanLogReader::next(CanFrame& frame) {
+    while (true) {
+        const char* lineBegin = buffer.data() + bufferPos;
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(lineBegin, '\n', bufferEnd - bufferPos));
+        if (lineEnd == nullptr) {
+            if (refill()) {
+                continue;
+            }
+            // Last line without a trailing new line
+            if (bufferPos == bufferEnd) {
+                return false;
+            }
+            lineBegin = buffer.data() + bufferPos;
+            lineEnd = buffer.data() + bufferEnd;
+        }
+        uint64_t lineOffset = bufferFileOffset + bufferPos;
+        bufferPos = std::min(static_cast<size_t>(lineEnd - buffer.data()) + 1, bufferEnd);
+        if (parseCandumpLine(lineBegin, lineEnd, frame)) {
+            frameOffset = lineOffset;
+            return true;
+        }
+    }
+}
+
+void CanLogReader::seek(uint64_t offset) {
+    // Nearby frames are often already in the buffer
+    if (offset >= bufferFileOffset && offset <= bufferFileOffset + bufferEnd) {
+        bufferPos = static_cast<size_t>(offset - bufferFileOffset);
+        return;
+    }
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    bufferFileOffset = offset;
+    bufferPos = 0;
+    bufferEnd = 0;
+    readSize = std::min(SEEK_READ_SIZE, buffer.size());
+    endOfFile = false;
+}
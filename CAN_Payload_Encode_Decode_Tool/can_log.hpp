@@ -0,0 +1,73 @@
+/*
+ *  can_log.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef CAN_LOG_HPP
+#define CAN_LOG_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include "dbc_parser.hpp"
+
+// One frame read from a trace or from the bus
+struct CanFrame {
+    // Microseconds
+    uint64_t timestamp{};
+    // Bus number, e.g. 1 for "can1"
+    unsigned int channel{};
+    unsigned long id{};
+    unsigned int size{};
+    unsigned char payload[MAX_MSG_LEN_CAN_FD]{};
+};
+
+// Parse one line of a candump log file (candump -l), e.g.
+//     (1436509052.249713) can0 18FEF100#0102030405060708
+//     (1436509052.249713) can1 123##1DEADBEEF
+// Extended IDs (8 hex digits) get CAN_ID_EXTENDED_FLAG set
+// Returns false if the line is not a frame
+bool parseCandumpLine(const char* begin, const char* end, CanFrame& frame);
+// Channel number of an interface name, taken from its trailing digits ("can1" is 1, "vcan" is 0)
+unsigned int channelFromInterfaceName(const char* begin, const char* end);
+
+// Sequential reader for candump log files that reads the file in large blocks
+// and keeps track of the byte offset of every frame, so frames can be revisited with seek()
+class CanLogReader {
+
+public:
+
+    explicit CanLogReader(const std::string& logPath, size_t bufferSize = 1 << 20);
+    // Read the next frame. Lines that are not frames are skipped
+    // Returns false at the end of the file
+    bool next(CanFrame& frame);
+    // Byte offset of the frame returned by the last call to next()
+    uint64_t getFrameOffset() const { return frameOffset; }
+    // Continue reading at a byte offset, which must be the start of a line
+    // Reads right after a seek are small and grow as reading goes on, so looking up single frames is cheap
+    void seek(uint64_t offset);
+    uint64_t getFileSize() const { return fileSize; }
+
+private:
+
+    std::ifstream file;
+    uint64_t fileSize = 0;
+    std::vector<char> buffer;
+    // Valid bytes are [bufferPos, bufferEnd)
+    size_t bufferPos = 0;
+    size_t bufferEnd = 0;
+    // File offset of buffer[0]
+    uint64_t bufferFileOffset = 0;
+    uint64_t frameOffset = 0;
+    // Bytes the next refill() reads at most
+    size_t readSize = 0;
+    bool endOfFile = false;
+    // Move the unread tail to the front of the buffer and read more
+    bool refill();
+
+};
+
+#endif
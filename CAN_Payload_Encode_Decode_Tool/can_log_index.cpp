@@ -0,0 +1,215 @@
+/*
+ *  can_log_index.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include "can_log_index.hpp"
+
+namespace {
+
+    // Index files use the native byte order of the machine that wrote them
+    const char INDEX_FILE_MAGIC[8] = { 'C', 'A', 'N', 'L', 'O', 'G', 'I', 'X' };
+    constexpr uint32_t INDEX_FILE_VERSION = 2;
+
+    template <typename T>
+    void writeValue(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T readValue(std::istream& in) {
+        T value{};
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::invalid_argument("Load failed. CAN log index file is truncated.");
+        }
+        return value;
+    }
+
+    // Decode one LEB128 varint starting at pos
+    inline uint64_t readVarint(const std::vector<unsigned char>& bytes, size_t& pos) {
+        uint64_t value = 0;
+        unsigned int shift = 0;
+        while (pos < bytes.size()) {
+            unsigned char byte = bytes[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+            shift += 7;
+        }
+        return value;
+    }
+
+}
+
+void CanLogIndex::PostingList::append(uint64_t offset) {
+    uint64_t delta = offset - lastOffset;
+    do {
+        unsigned char byte = delta & 0x7f;
+        delta >>= 7;
+        encodedOffsets.push_back(delta ? (byte | 0x80) : byte);
+    } while (delta);
+    lastOffset = offset;
+    count++;
+}
+
+CanLogIndex CanLogIndex::build(const std::string& logPath, unsigned int checkpointInterval) {
+    if (checkpointInterval == 0) {
+        checkpointInterval = 1;
+    }
+    CanLogIndex index;
+    CanLogReader reader(logPath);
+    index.logSize = reader.getFileSize();
+    CanFrame frame;
+    uint64_t frameCount = 0;
+    while (reader.next(frame)) {
+        if (frameCount % checkpointInterval == 0) {
+            index.checkpoints.push_back({ frame.timestamp, reader.getFrameOffset() });
+        }
+        index.postingLists[postingKey(frame.channel, frame.id)].append(reader.getFrameOffset());
+        frameCount++;
+    }
+    return index;
+}
+
+void CanLogIndex::save(const std::string& indexPath) const {
+    std::ofstream out(indexPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::invalid_argument("Save failed. Could not open \"" + indexPath + "\" for writing.");
+    }
+    out.write(INDEX_FILE_MAGIC, sizeof(INDEX_FILE_MAGIC));
+    writeValue(out, INDEX_FILE_VERSION);
+    writeValue(out, logSize);
+    writeValue(out, static_cast<uint64_t>(checkpoints.size()));
+    for (auto& checkpoint : checkpoints) {
+        writeValue(out, checkpoint.timestamp);
+        writeValue(out, checkpoint.offset);
+    }
+    writeValue(out, static_cast<uint64_t>(postingLists.size()));
+    for (auto& list : postingLists) {
+        writeValue(out, list.first);
+        writeValue(out, list.second.count);
+        writeValue(out, list.second.lastOffset);
+        writeValue(out, static_cast<uint64_t>(list.second.encodedOffsets.size()));
+        out.write(reinterpret_cast<const char*>(list.second.encodedOffsets.data()),
+            static_cast<std::streamsize>(list.second.encodedOffsets.size()));
+    }
+    if (!out) {
+        throw std::invalid_argument("Save failed. Could not write CAN log index file.");
+    }
+}
+
+CanLogIndex CanLogIndex::load(const std::string& indexPath, const std::string& logPath) {
+    std::ifstream in(indexPath.c_str(), std::ios::binary);
+    if (!in) {
+        throw std::invalid_argument("Load failed. Could not open CAN log index file.");
+    }
+    char magic[sizeof(INDEX_FILE_MAGIC)];
+    if (!in.read(magic, sizeof(magic))
+        || !std::equal(magic, magic + sizeof(magic), INDEX_FILE_MAGIC)
+        || readValue<uint32_t>(in) != INDEX_FILE_VERSION) {
+        throw std::invalid_argument("Load failed. Not a CAN log index file or unsupported version.");
+    }
+    CanLogIndex index;
+    index.logSize = readValue<uint64_t>(in);
+    std::ifstream log(logPath.c_str(), std::ios::binary | std::ios::ate);
+    if (!log) {
+        throw std::invalid_argument("Could not open CAN log file \"" + logPath + "\".");
+    }
+    if (static_cast<uint64_t>(log.tellg()) != index.logSize) {
+        throw std::invalid_argument("Load failed. CAN log index file does not match \"" + logPath
+            + "\", the log changed since the index was built.");
+    }
+    uint64_t checkpointCount = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < checkpointCount; i++) {
+        Checkpoint checkpoint;
+        checkpoint.timestamp = readValue<uint64_t>(in);
+        checkpoint.offset = readValue<uint64_t>(in);
+        index.checkpoints.push_back(checkpoint);
+    }
+    uint64_t listCount = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < listCount; i++) {
+        PostingList& list = index.postingLists[readValue<uint64_t>(in)];
+        list.count = readValue<uint64_t>(in);
+        list.lastOffset = readValue<uint64_t>(in);
+        list.encodedOffsets.resize(static_cast<size_t>(readValue<uint64_t>(in)));
+        if (!in.read(reinterpret_cast<char*>(list.encodedOffsets.data()),
+            static_cast<std::streamsize>(list.encodedOffsets.size()))) {
+            throw std::invalid_argument("Load failed. CAN log index file is truncated.");
+        }
+    }
+    return index;
+}
+
+uint64_t CanLogIndex::findOffset(uint64_t timestamp) const {
+    // Start from the last checkpoint strictly before the timestamp, so that frames
+    // sharing the timestamp right before a checkpoint are not skipped
+    auto checkpoint_itr = std::lower_bound(checkpoints.begin(), checkpoints.end(), timestamp,
+        [](const Checkpoint& checkpoint, uint64_t value) { return checkpoint.timestamp < value; });
+    if (checkpoint_itr == checkpoints.begin()) {
+        return 0;
+    }
+    return (checkpoint_itr - 1)->offset;
+}
+
+std::vector<uint64_t> CanLogIndex::getFrameOffsets(unsigned int channel, unsigned long msgId) const {
+    std::vector<uint64_t> offsets;
+    auto list_itr = postingLists.find(postingKey(channel, msgId));
+    if (list_itr == postingLists.end()) {
+        return offsets;
+    }
+    offsets.reserve(static_cast<size_t>(list_itr->second.count));
+    uint64_t offset = 0;
+    size_t pos = 0;
+    while (pos < list_itr->second.encodedOffsets.size()) {
+        offset += readVarint(list_itr->second.encodedOffsets, pos);
+        offsets.push_back(offset);
+    }
+    return offsets;
+}
+
+uint64_t CanLogIndex::getFrameCount(unsigned int channel, unsigned long msgId) const {
+    auto list_itr = postingLists.find(postingKey(channel, msgId));
+    return list_itr == postingLists.end() ? 0 : list_itr->second.count;
+}
+
+void CanLogIndex::forEachFrameInRange(
+    CanLogReader& reader,
+    uint64_t startTime,
+    uint64_t endTime,
+    const FrameCallback& callback) const {
+    reader.seek(findOffset(startTime));
+    CanFrame frame;
+    while (reader.next(frame) && frame.timestamp < endTime) {
+        if (frame.timestamp >= startTime) {
+            callback(frame);
+        }
+    }
+}
+
+void CanLogIndex::forEachFrameOfMessage(
+    CanLogReader& reader,
+    unsigned int channel,
+    unsigned long msgId,
+    const FrameCallback& callback) const {
+    auto list_itr = postingLists.find(postingKey(channel, msgId));
+    if (list_itr == postingLists.end()) {
+        return;
+    }
+    const std::vector<unsigned char>& encodedOffsets = list_itr->second.encodedOffsets;
+    CanFrame frame;
+    uint64_t offset = 0;
+    size_t pos = 0;
+    while (pos < encodedOffsets.size()) {
+        offset += readVarint(encodedOffsets, pos);
+        reader.seek(offset);
+        if (reader.next(frame)) {
+            callback(frame);
+        }
+    }
+}
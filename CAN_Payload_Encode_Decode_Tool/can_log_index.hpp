@@ -0,0 +1,70 @@
+/*
+ *  can_log_index.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef CAN_LOG_INDEX_HPP
+#define CAN_LOG_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "can_log.hpp"
+
+// Sidecar index of a candump log file. It holds sparse timestamp to offset checkpoints
+// and, per channel and message ID, the offsets of every frame of that message, so a time
+// window or a single message can be read without scanning the whole log
+class CanLogIndex {
+
+public:
+
+    typedef std::function<void(const CanFrame& frame)> FrameCallback;
+
+    // Scan a log once. A checkpoint is recorded every checkpointInterval frames
+    static CanLogIndex build(const std::string& logPath, unsigned int checkpointInterval = 4096);
+    // Store and reload the index, e.g. as "<log>.idx"
+    void save(const std::string& indexPath) const;
+    // Throws if the log no longer has the size it had when the index was built
+    static CanLogIndex load(const std::string& indexPath, const std::string& logPath);
+    // Byte offset to start reading from to find the first frame with timestamp >= timestamp
+    uint64_t findOffset(uint64_t timestamp) const;
+    // Offsets of all frames of one message on one channel, in file order
+    std::vector<uint64_t> getFrameOffsets(unsigned int channel, unsigned long msgId) const;
+    uint64_t getFrameCount(unsigned int channel, unsigned long msgId) const;
+    // Read the frames with startTime <= timestamp < endTime. Timestamps must increase through the log
+    void forEachFrameInRange(CanLogReader& reader, uint64_t startTime, uint64_t endTime, const FrameCallback& callback) const;
+    // Read only the frames of one message on one channel
+    void forEachFrameOfMessage(CanLogReader& reader, unsigned int channel, unsigned long msgId,
+        const FrameCallback& callback) const;
+    // Size of the log file the index was built from
+    uint64_t getLogSize() const { return logSize; }
+
+private:
+
+    struct Checkpoint {
+        uint64_t timestamp;
+        uint64_t offset;
+    };
+    // Offsets are stored as variable-length deltas, a frame usually takes 1 or 2 bytes
+    struct PostingList {
+        std::vector<unsigned char> encodedOffsets;
+        uint64_t count = 0;
+        uint64_t lastOffset = 0;
+        void append(uint64_t offset);
+    };
+    uint64_t logSize = 0;
+    std::vector<Checkpoint> checkpoints;
+    // <(channel << 32) | message id, offsets>
+    std::unordered_map<uint64_t, PostingList> postingLists;
+
+    static uint64_t postingKey(unsigned int channel, unsigned long msgId) {
+        return (static_cast<uint64_t>(channel) << 32) | (msgId & 0xFFFFFFFFUL);
+    }
+
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ *  cycle_time_monitor.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <bit>
+#include <algorithm>
+#include <stdexcept>
+#include "cycle_time_monitor.hpp"
+
+namespace {
+
+    uint64_t hashId(unsigned long msgId) {
+        // Fibonacci hashing, spreads the mostly sequential CAN IDs over the index
+        return (static_cast<uint64_t>(msgId) * 0x9E3779B97F4A7C15ULL) >> 32;
+    }
+
+}
+
+CycleTimeMonitor::CycleTimeMonitor(const DbcParser& dbcFile, double timeoutFactor,
+    double tolerance, uint64_t tickMicroseconds) : tickMicroseconds(tickMicroseconds) {
+    if (tickMicroseconds == 0 || timeoutFactor <= 0 || tolerance < 0) {
+        throw std::invalid_argument("Cycle time monitor failed. "
+            "Tick, timeout factor and tolerance must be positive.");
+    }
+    wheel.fill(NO_TIMER);
+    std::vector<std::pair<unsigned long, unsigned int> > cyclicMessages = dbcFile.getCyclicMessages();
+    timers.resize(cyclicMessages.size());
+    idIndex.assign(std::max<size_t>(16, std::bit_ceil(cyclicMessages.size() * 2)), 0);
+    idIndexMask = idIndex.size() - 1;
+    for (size_t i = 0; i < cyclicMessages.size(); i++) {
+        MessageTimer& timer = timers[i];
+        uint64_t cycleTime = static_cast<uint64_t>(cyclicMessages[i].second) * 1000;
+        timer.statistics.msgId = cyclicMessages[i].first;
+        timer.statistics.cycleTime = cycleTime;
+        timer.timeout = std::max<uint64_t>(1, static_cast<uint64_t>(cycleTime * timeoutFactor));
+        timer.minAllowedInterval = static_cast<uint64_t>(cycleTime * std::max(0.0, 1 - tolerance));
+        timer.maxAllowedInterval = static_cast<uint64_t>(cycleTime * (1 + tolerance));
+        uint64_t slot = hashId(timer.statistics.msgId) & idIndexMask;
+        while (idIndex[slot] != 0) {
+            slot = (slot + 1) & idIndexMask;
+        }
+        idIndex[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+uint32_t CycleTimeMonitor::findTimer(unsigned long msgId) const {
+    uint64_t slot = hashId(msgId) & idIndexMask;
+    while (idIndex[slot] != 0) {
+        uint32_t timerIndex = idIndex[slot] - 1;
+        if (timers[timerIndex].statistics.msgId == msgId) {
+            return timerIndex;
+        }
+        slot = (slot + 1) & idIndexMask;
+    }
+    return NO_TIMER;
+}
+
+void CycleTimeMonitor::schedule(uint32_t timerIndex, uint64_t deadline) {
+    unschedule(timerIndex);
+    MessageTimer& timer = timers[timerIndex];
+    timer.deadline = deadline;
+    // A deadline in a bucket that was already checked goes into the next bucket to check
+    uint64_t deadlineTick = std::max(deadline / tickMicroseconds, processedTick);
+    timer.bucket = static_cast<uint32_t>(deadlineTick & (TIMER_WHEEL_SIZE - 1));
+    uint32_t& bucket = wheel[timer.bucket];
+    timer.prev = NO_TIMER;
+    timer.next = bucket;
+    if (bucket != NO_TIMER) {
+        timers[bucket].prev = timerIndex;
+    }
+    bucket = timerIndex;
+    timer.isScheduled = true;
+}
+
+void CycleTimeMonitor::unschedule(uint32_t timerIndex) {
+    MessageTimer& timer = timers[timerIndex];
+    if (!timer.isScheduled) {
+        return;
+    }
+    if (timer.prev != NO_TIMER) {
+        timers[timer.prev].next = timer.next;
+    }
+    else {
+        wheel[timer.bucket] = timer.next;
+    }
+    if (timer.next != NO_TIMER) {
+        timers[timer.next].prev = timer.prev;
+    }
+    timer.next = NO_TIMER;
+    timer.prev = NO_TIMER;
+    timer.isScheduled = false;
+}
+
+void CycleTimeMonitor::advance(uint64_t now) {
+    uint64_t nowTick = now / tickMicroseconds;
+    if (!isStarted) {
+        processedTick = nowTick;
+        isStarted = true;
+        return;
+    }
+    // After a long gap every bucket is checked once, not once per tick
+    if (nowTick > processedTick + TIMER_WHEEL_SIZE) {
+        processedTick = nowTick - TIMER_WHEEL_SIZE;
+    }
+    // A bucket is checked once its whole tick has passed, so timeouts are at most one tick late
+    while (processedTick < nowTick) {
+        uint64_t tick = processedTick;
+        uint32_t timerIndex = wheel[tick & (TIMER_WHEEL_SIZE - 1)];
+        while (timerIndex != NO_TIMER) {
+            MessageTimer& timer = timers[timerIndex];
+            uint32_t nextIndex = timer.next;
+            // Timers of later turns of the wheel stay in the bucket
+            if (timer.deadline / tickMicroseconds <= tick) {
+                unschedule(timerIndex);
+                timer.statistics.timeoutCount++;
+                timer.statistics.isTimedOut = true;
+                report(CycleTimeEventType::Timeout, timer, timer.deadline, timer.deadline - timer.lastSeen);
+            }
+            timerIndex = nextIndex;
+        }
+        processedTick++;
+    }
+}
+
+bool CycleTimeMonitor::onFrame(unsigned long msgId, uint64_t timestamp) {
+    advance(timestamp);
+    uint32_t timerIndex = findTimer(msgId);
+    if (timerIndex == NO_TIMER) {
+        return false;
+    }
+    MessageTimer& timer = timers[timerIndex];
+    CycleTimeStatistics& statistics = timer.statistics;
+    statistics.frameCount++;
+    uint64_t interval = 0;
+    if (timer.hasFrame) {
+        interval = timestamp > timer.lastSeen ? timestamp - timer.lastSeen : 0;
+        if (statistics.frameCount == 2 || interval < statistics.minInterval) {
+            statistics.minInterval = interval;
+        }
+        statistics.maxInterval = std::max(statistics.maxInterval, interval);
+        uint64_t deviation = interval > statistics.cycleTime
+            ? interval - statistics.cycleTime
+            : statistics.cycleTime - interval;
+        statistics.jitterHistogram[std::min<unsigned int>(std::bit_width(deviation), JITTER_BUCKET_COUNT - 1)]++;
+    }
+    if (statistics.isTimedOut) {
+        statistics.isTimedOut = false;
+        report(CycleTimeEventType::Recovered, timer, timestamp, interval);
+    }
+    else if (timer.hasFrame && interval < timer.minAllowedInterval) {
+        statistics.tooFastCount++;
+        report(CycleTimeEventType::TooFast, timer, timestamp, interval);
+    }
+    else if (timer.hasFrame && interval > timer.maxAllowedInterval) {
+        statistics.tooSlowCount++;
+        report(CycleTimeEventType::TooSlow, timer, timestamp, interval);
+    }
+    timer.lastSeen = timestamp;
+    timer.hasFrame = true;
+    schedule(timerIndex, timestamp + timer.timeout);
+    return true;
+}
+
+void CycleTimeMonitor::armAll(uint64_t now) {
+    advance(now);
+    for (uint32_t timerIndex = 0; timerIndex < timers.size(); timerIndex++) {
+        MessageTimer& timer = timers[timerIndex];
+        if (!timer.isScheduled && !timer.statistics.isTimedOut) {
+            if (!timer.hasFrame) {
+                timer.lastSeen = now;
+            }
+            schedule(timerIndex, now + timer.timeout);
+        }
+    }
+}
+
+std::optional<CycleTimeStatistics> CycleTimeMonitor::getStatistics(unsigned long msgId) const {
+    uint32_t timerIndex = findTimer(msgId);
+    if (timerIndex == NO_TIMER) {
+        return std::nullopt;
+    }
+    return timers[timerIndex].statistics;
+}
+
+std::vector<CycleTimeStatistics> CycleTimeMonitor::getStatistics() const {
+    std::vector<CycleTimeStatistics> statistics;
+    statistics.reserve(timers.size());
+    for (auto& timer : timers) {
+        statistics.push_back(timer.statistics);
+    }
+    return statistics;
+}
+
+void CycleTimeMonitor::resetStatistics() {
+    for (auto& timer : timers) {
+        CycleTimeStatistics& statistics = timer.statistics;
+        statistics = { statistics.msgId, statistics.cycleTime, 0, 0, 0, 0, 0, 0, {}, statistics.isTimedOut };
+        // The next interval is measured from the next frame
+        timer.hasFrame = false;
+    }
+}
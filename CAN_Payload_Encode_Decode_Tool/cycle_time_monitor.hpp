@@ -0,0 +1,131 @@
+/*
+ *  cycle_time_monitor.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef CYCLE_TIME_MONITOR_HPP
+#define CYCLE_TIME_MONITOR_HPP
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+
+// Jitter bucket i holds deviations from the cycle time in [2^(i-1), 2^i) microseconds,
+// the last bucket is open ended
+constexpr unsigned int JITTER_BUCKET_COUNT = 24;
+// Number of buckets of the timer wheel, a power of two
+constexpr unsigned int TIMER_WHEEL_SIZE = 4096;
+
+enum class CycleTimeEventType {
+    // No frame within the timeout of the message
+    Timeout,
+    // First frame after a timeout
+    Recovered,
+    // The time since the previous frame is shorter than the cycle time allows
+    TooFast,
+    // The time since the previous frame is longer than the cycle time allows, but no timeout
+    TooSlow
+};
+
+struct CycleTimeEvent {
+    CycleTimeEventType type = CycleTimeEventType::Timeout;
+    unsigned long msgId{};
+    // Microseconds, the frame time or for timeouts the time the timeout was detected
+    uint64_t timestamp{};
+    // Time since the previous frame of the message
+    uint64_t interval{};
+};
+
+struct CycleTimeStatistics {
+    unsigned long msgId{};
+    // Microseconds
+    uint64_t cycleTime{};
+    uint64_t frameCount{};
+    uint64_t timeoutCount{};
+    uint64_t tooFastCount{};
+    uint64_t tooSlowCount{};
+    uint64_t minInterval{};
+    uint64_t maxInterval{};
+    // Absolute deviation of every interval from the cycle time
+    std::array<uint64_t, JITTER_BUCKET_COUNT> jitterHistogram{};
+    bool isTimedOut = false;
+};
+
+// Watches the send period of every message that has a GenMsgCycleTime in the database.
+// Each frame updates one slot of a flat table, found through an open addressing index,
+// and moves the timeout of its message on a hashed timer wheel. Timeouts are found by
+// turning the wheel, so the cost does not depend on how many messages are watched.
+// Time comes from the frame timestamps, the monitor is not thread-safe
+class CycleTimeMonitor {
+
+public:
+
+    typedef std::function<void(const CycleTimeEvent& event)> EventCallback;
+
+    // A message times out after timeoutFactor cycle times without a frame. Intervals that
+    // differ from the cycle time by more than tolerance (0.2 is 20%) are rate violations
+    // The timer wheel turns in steps of tickMicroseconds, which is the resolution of timeouts
+    explicit CycleTimeMonitor(const DbcParser& dbcFile, double timeoutFactor = 3.0,
+        double tolerance = 0.2, uint64_t tickMicroseconds = 1000);
+    // Called for timeouts, recoveries and rate violations
+    void setEventCallback(EventCallback callback) { eventCallback = std::move(callback); }
+    // Record a frame, timestamp in microseconds. Expired timeouts are reported first
+    // Returns false if the message is not watched
+    bool onFrame(unsigned long msgId, uint64_t timestamp);
+    bool onFrame(const CanFrame& frame) { return onFrame(frame.id, frame.timestamp); }
+    // Report the timeouts that expired up to now, e.g. while the bus is silent
+    void advance(uint64_t now);
+    // Start the timeouts of all messages at once, so messages that are never seen time out too
+    // Otherwise the timeout of a message starts with its first frame
+    void armAll(uint64_t now);
+    size_t getMessageCount() const { return timers.size(); }
+    std::optional<CycleTimeStatistics> getStatistics(unsigned long msgId) const;
+    std::vector<CycleTimeStatistics> getStatistics() const;
+    void resetStatistics();
+
+private:
+
+    static constexpr uint32_t NO_TIMER = 0xFFFFFFFF;
+    struct MessageTimer {
+        CycleTimeStatistics statistics;
+        uint64_t timeout = 0;
+        uint64_t minAllowedInterval = 0;
+        uint64_t maxAllowedInterval = 0;
+        uint64_t lastSeen = 0;
+        uint64_t deadline = 0;
+        // Doubly linked list of the timers in one wheel bucket
+        uint32_t next = NO_TIMER;
+        uint32_t prev = NO_TIMER;
+        uint32_t bucket = 0;
+        bool isScheduled = false;
+        bool hasFrame = false;
+    };
+    std::vector<MessageTimer> timers;
+    // Open addressing index, <slot, timer index + 1>, 0 marks an empty slot
+    std::vector<uint32_t> idIndex;
+    uint64_t idIndexMask = 0;
+    std::array<uint32_t, TIMER_WHEEL_SIZE> wheel;
+    uint64_t tickMicroseconds;
+    // The buckets of all ticks before this one have been checked
+    uint64_t processedTick = 0;
+    bool isStarted = false;
+    EventCallback eventCallback;
+
+    uint32_t findTimer(unsigned long msgId) const;
+    void schedule(uint32_t timerIndex, uint64_t deadline);
+    void unschedule(uint32_t timerIndex);
+    void report(CycleTimeEventType type, const MessageTimer& timer, uint64_t timestamp, uint64_t interval) {
+        if (eventCallback) {
+            eventCallback({ type, timer.statistics.msgId, timestamp, interval });
+        }
+    }
+
+};
+
+#endif
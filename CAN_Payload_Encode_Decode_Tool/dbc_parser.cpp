@@ -6,264 +6,778 @@
  */
 
 #include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
+#include <string_view>
 #include "dbc_parser.hpp"
+#include "dbc_parser_dependencies/output_buffer.hpp"
+
+namespace {
+
+    inline const char* findLineEnd(const char* lineBegin, const char* textEnd) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', textEnd - lineBegin));
+        return lineEnd ? lineEnd : textEnd;
+    }
+
+    // First word of a line, wordEnd is set to the character after it
+    inline std::string_view firstWord(const char* lineBegin, const char* lineEnd, const char*& wordEnd) {
+        const char* wordBegin = lineBegin;
+        while (wordBegin < lineEnd && (*wordBegin == ' ' || *wordBegin == '\t' || *wordBegin == '\r')) {
+            wordBegin++;
+        }
+        wordEnd = wordBegin;
+        while (wordEnd < lineEnd && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r') {
+            wordEnd++;
+        }
+        return std::string_view(wordBegin, static_cast<size_t>(wordEnd - wordBegin));
+    }
+
+#ifdef DBC_PARSER_ENABLE_TRACING
+    // Span name of a statement. DBC files group statements by kind, so consecutive
+    // statements of one kind are traced as one phase
+    const char* statementPhaseName(const std::string& lineInitial) {
+        if (lineInitial == "BO_") {
+            return "parse.BO_";
+        }
+        if (lineInitial == "VAL_") {
+            return "parse.VAL_";
+        }
+        if (lineInitial == "BA_DEF_" || lineInitial == "BA_DEF_DEF_") {
+            return "parse.BA_DEF_";
+        }
+        if (lineInitial == "BA_") {
+            return "parse.BA_";
+        }
+        if (lineInitial == "SIG_VALTYPE_") {
+            return "parse.SIG_VALTYPE_";
+        }
+        return "parse.other";
+    }
+#endif
+
+}
 
 std::ostream& operator<<(std::ostream& os, const DbcParser& dbcFile) {
     if (dbcFile.isEmptyLibrary) {
-        std::cout << "Empty Library. Load and parse DBC file first." << std::endl;
+        os << "Empty Library. Load and parse DBC file first.\n";
         return os;
     }
+    // Format into one buffer and hand it to the stream in blocks. The buffer is sized for
+    // the dump, about 200 bytes per signal, so small databases do not allocate a full block
+    size_t expectedSize = 64 * (dbcFile.messagesInfo.size() + 1) + 200 * dbcFile.getSignalCount();
+    OutputBuffer out(os, std::min(expectedSize, OUTPUT_BUFFER_SIZE));
     // Print details for each signal and message
     for (auto message : dbcFile.messagesInfo) {
-        std::cout << "-------------------------------" << std::endl;
-        std::cout << "<Message> "
-            << message->getName()
-            << " "
-            << (*message).getId()
-            << " "
-            << (*message).getDlc()
-            << std::endl;
-        for (auto& sig : message->getSignalsInfo()) {
-            std::cout << "<Signal> "
-                << sig.second.getName()
-                << "  "
-                << std::endl;
-            std::cout << "\t\tStart bit/Sig size: "
-                << sig.second.getStartBit()
-                << ","
-                << sig.second.getSignalSize()
-                << std::endl;
-            std::cout << "\t\tFactor/Offset: ("
-                << sig.second.getFactor()
-                << ", "
-                << sig.second.getOffset()
-                << ")" << std::endl;
-            std::cout << "\t\tMin/Max: ["
-                << sig.second.getMinValue()
-                << ","
-                << sig.second.getMaxValue()
-                << "]"
-                << std::endl;
-            if (sig.second.getByteOrder() == ByteOrder::Intel) {
-                std::cout << "\t\tINTEL" << std::endl;
-            }
-            else { std::cout << "\t\tMOTO" << std::endl; }
+        dbcFile.ensureMessageParsed(message->getIndex());
+        out.append("-------------------------------\n<Message> ");
+        out.append(message->getName());
+        out.append(' ');
+        out.appendNumber(message->getId());
+        out.append(' ');
+        out.appendNumber(message->getDlc());
+        out.append('\n');
+        for (auto& sig : message->getSignals()) {
+            out.append("<Signal> ");
+            out.append(sig.second.getNameView());
+            out.append("  \n\t\tStart bit/Sig size: ");
+            out.appendNumber(sig.second.getStartBit());
+            out.append(',');
+            out.appendNumber(sig.second.getSignalSize());
+            out.append("\n\t\tFactor/Offset: (");
+            out.appendNumber(sig.second.getFactor());
+            out.append(", ");
+            out.appendNumber(sig.second.getOffset());
+            out.append(")\n\t\tMin/Max: [");
+            out.appendNumber(sig.second.getMinValue());
+            out.append(',');
+            out.appendNumber(sig.second.getMaxValue());
+            out.append("]\n");
+            out.append(sig.second.getByteOrder() == ByteOrder::Intel ? "\t\tINTEL\n" : "\t\tMOTO\n");
             switch (sig.second.getValueTypes()) {
             case ValueType::Unsigned:
-                std::cout << "\t\tUNSIGNED" << std::endl;
+                out.append("\t\tUNSIGNED\n");
                 break;
             case ValueType::Signed:
-                std::cout << "\t\tSIGNED" << std::endl;
+                out.append("\t\tSIGNED\n");
                 break;
             case ValueType::IeeeFloat:
-                std::cout << "\t\tIEEE Float" << std::endl;
+                out.append("\t\tIEEE Float\n");
                 break;
             case ValueType::IeeeDouble:
-                std::cout << "\t\tIEEE Double" << std::endl;
+                out.append("\t\tIEEE Double\n");
                 break;
             default:
                 break;
             }
-            if (sig.second.getUnit() != "") {
-                std::cout << "\t\t" << sig.second.getUnit() << std::endl;
+            if (!sig.second.getUnitView().empty()) {
+                out.append("\t\t");
+                out.append(sig.second.getUnitView());
+                out.append('\n');
             }
             if (sig.second.getInitialValue().has_value()) {
-                std::cout << "\t\tInitial value: "
-                    << sig.second.getInitialValue().value()
-                    << std::endl;
+                out.append("\t\tInitial value: ");
+                out.appendNumber(sig.second.getInitialValue().value());
+                out.append('\n');
             }
-            std::cout << std::endl;
+            out.append('\n');
         }
     }
-    std::cout << "-------------------------------" << std::endl;
+    out.append("-------------------------------\n");
     return os;
 }
 
 void DbcParser::loadAndParseFromFile(std::istream& in) {
     std::string lineInitial;
+    DBC_TRACE_PHASES(phases);
     // Read the file line by line
     while (in >> lineInitial) {
+        DBC_TRACE_PHASE(phases, statementPhaseName(lineInitial));
         // Get the first word in the line
         if (lineInitial == "NS_") {
             while (in >> lineInitial && !(lineInitial == "BS_:" || lineInitial == "BS_"));
         }
-        // Messages
-        if (lineInitial == "BO_") {
-            // Parse the message
-            Message msg;
-            in >> msg;
-            // Message name uniqueness check. Message names by definition need to be unqiue within the file
-            messageLibrary_iterator data_itr = messageLibrary.find(msg.getId());
-            if (data_itr == messageLibrary.end()) {
-                // Uniqueness check passed, store the message
-                messageLibrary.insert(std::make_pair(msg.getId(), msg));
-                data_itr = messageLibrary.find(msg.getId());
-                messagesInfo.push_back(&(data_itr->second));
+        parseStatement(lineInitial, in);
+        // Skip the rest of the line for uninterested data
+        // Make sure we can get a whole new line in the next iteration
+        in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    DBC_TRACE_PHASE(phases, "parse.finishLoading");
+    assignSignalHandles();
+    finishLoading();
+}
+
+// Parse one statement of the DBC file, starting after its first word
+void DbcParser::parseStatement(const std::string& lineInitial, std::istream& in) {
+    // Messages
+    if (lineInitial == "BO_") {
+        // Parse the message straight into the arena
+        Message msg(messageLibrary.get_allocator());
+        in >> msg;
+        // Message name uniqueness check. Message names by definition need to be unqiue within the file
+        // The message is moved into the library, its signals are not copied
+        auto inserted = messageLibrary.try_emplace(msg.getId(), std::move(msg));
+        if (inserted.second) {
+            // Uniqueness check passed, store the message
+            inserted.first->second.setIndex(static_cast<unsigned int>(messagesInfo.size()));
+            messagesInfo.push_back(&(inserted.first->second));
+        }
+        else {
+            throw std::invalid_argument("Parse Failed. Message \""
+                + msg.getName()
+                + "\" has a duplicate.");
+        }
+    }
+    // Value descriptions
+    else if (lineInitial == "VAL_") {
+        // There are two types of value descriptions: Environment variable value descriptions and Signal value descriptions
+        // Environment variable value descriptions provide textual representations of specific values of the variable.
+        // Signal value descriptions define encodings for specific signal raw values.
+        // Check "DBC File Format Documentation" if confused
+        unsigned int messageId;
+        in >> messageId;
+        if (messageId != 0) {
+            // If there exists a message ID, this is a signal value description
+            messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
+            if (messages_itr != messageLibrary.end()) {
+                // Search for signals to store signal value description
+                messages_itr->second.parseSigValueDescription(in);
             }
             else {
-                throw std::invalid_argument("Parse Failed. Message \""
-                    + msg.getName()
-                    + "\" has a duplicate.");
+                throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
+                    + std::to_string(messageId)
+                    + ") for a given signal value description.");
+            }
+        }
+    }
+    // Attribute definitions
+    else if (lineInitial == "BA_DEF_") {
+        std::string objectType;
+        in >> objectType;
+        if (objectType == "SG_") {
+            std::string attributeName;
+            getline(in, attributeName, '\"');
+            getline(in, attributeName, '\"');
+            if (attributeName == "GenSigStartValue") {
+                in >> attributeName;
+                in >> sigGlobalInitialValueMin;
+                in >> sigGlobalInitialValueMax;
+            }
+        }
+    }
+    // Attribute defaults
+    else if (lineInitial == "BA_DEF_DEF_") {
+        std::string attributeName;
+        getline(in, attributeName, '\"');
+        getline(in, attributeName, '\"');
+        if (attributeName == "GenSigStartValue") {
+            in >> sigGlobalInitialValue;
+        }
+        else if (attributeName == "GenMsgCycleTime") {
+            in >> msgGlobalCycleTime;
+        }
+    }
+    // Attribute values
+    else if (lineInitial == "BA_") {
+        std::string attributeName;
+        getline(in, attributeName, '\"');
+        getline(in, attributeName, '\"');
+        // Detect bus type
+        if (attributeName == "BusType") {
+            std::string busTypeName;
+            getline(in, busTypeName, '\"');
+            getline(in, busTypeName, '\"');
+            if (busTypeName == "CAN") {
+                databaseBusType = BusType::CAN;
+            }
+            else if (busTypeName == "CAN FD") {
+                databaseBusType = BusType::CAN_FD;
+            }
+            else {
+                databaseBusType = BusType::Unknown;
+                throw std::invalid_argument("Parse Failed. Unknown bus type.");
+            }
+        }
+        // J1939 databases
+        else if (attributeName == "ProtocolType") {
+            std::string protocolName;
+            getline(in, protocolName, '\"');
+            getline(in, protocolName, '\"');
+            if (protocolName == "J1939") {
+                j1939Mode = true;
             }
         }
-        // Value descriptions
-        else if (lineInitial == "VAL_") {
-            // There are two types of value descriptions: Environment variable value descriptions and Signal value descriptions
-            // Environment variable value descriptions provide textual representations of specific values of the variable.
-            // Signal value descriptions define encodings for specific signal raw values.
-            // Check "DBC File Format Documentation" if confused
-            unsigned int messageId;
-            in >> messageId;
-            if (messageId != 0) {
-                // If there exists a message ID, this is a signal value description
+        // Message send periods in ms
+        else if (attributeName == "GenMsgCycleTime" || attributeName == "GenMsgCycleTimeFast") {
+            std::string objectType;
+            in >> objectType;
+            if (objectType == "BO_") {
+                unsigned long messageId;
+                unsigned int cycleTime;
+                in >> messageId >> cycleTime;
                 messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
-                if (messages_itr != messageLibrary.end()) {
-                    // Search for signals to store signal value description
-                    messages_itr->second.parseSigValueDescription(in);
-                }
-                else {
+                if (messages_itr == messageLibrary.end()) {
                     throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
                         + std::to_string(messageId)
-                        + ") for a given signal value description.");
+                        + ") for a given message cycle time.");
+                }
+                if (attributeName == "GenMsgCycleTime") {
+                    messages_itr->second.setCycleTime(cycleTime);
+                }
+                else {
+                    messages_itr->second.setFastCycleTime(cycleTime);
                 }
             }
         }
-        // Attribute definitions
-        else if (lineInitial == "BA_DEF_") {
+        // Signal specific initial values
+        if (attributeName == "GenSigStartValue") {
             std::string objectType;
             in >> objectType;
             if (objectType == "SG_") {
-                std::string attributeName;
-                getline(in, attributeName, '\"');
-                getline(in, attributeName, '\"');
-                if (attributeName == "GenSigStartValue") {
-                    in >> attributeName;
-                    in >> sigGlobalInitialValueMin;
-                    in >> sigGlobalInitialValueMax;
+                unsigned int messageId;
+                in >> messageId;
+                messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
+                if (messages_itr != messageLibrary.end()) {
+                    messages_itr->second.parseSigInitialValue(in);
+                }
+                else {
+                    throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
+                        + std::to_string(messageId)
+                        + ") for a given signal value description.");
                 }
             }
         }
-        // Attribute defaults
-        else if (lineInitial == "BA_DEF_DEF_") {
-            std::string attributeName;
-            getline(in, attributeName, '\"');
-            getline(in, attributeName, '\"');
-            if (attributeName == "GenSigStartValue") {
-                in >> sigGlobalInitialValue;
-            }
+    }
+    // Additional signal value type
+    else if (lineInitial == "SIG_VALTYPE_") {
+        unsigned int messageId;
+        in >> messageId;
+        messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
+        if (messages_itr != messageLibrary.end()) {
+            messages_itr->second.parseAdditionalSigValueType(in);
         }
-        // Attribute values
-        else if (lineInitial == "BA_") {
-            std::string attributeName;
-            getline(in, attributeName, '\"');
-            getline(in, attributeName, '\"');
-            // Detect bus type
-            if (attributeName == "BusType") {
-                std::string busTypeName;
-                getline(in, busTypeName, '\"');
-                getline(in, busTypeName, '\"');
-                if (busTypeName == "CAN") {
-                    databaseBusType = BusType::CAN;
-                }
-                else if (busTypeName == "CAN FD") {
-                    databaseBusType = BusType::CAN_FD;
+        else {
+            throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
+                + std::to_string(messageId)
+                + ") for a given signal value type attribute.");
+        }
+    }
+    else {
+        // Reserved cases for parsing other info in the DBC file
+    }
+}
+
+void DbcParser::finishLoading() {
+    buildPgnLibrary();
+    buildSignalNameIndex();
+    std::vector<unsigned long> messageIds;
+    for (auto message : messagesInfo) {
+        messageIds.push_back(message->getId());
+        // BA_DEF_DEF_ "GenMsgCycleTime" applies to messages without their own cycle time
+        if (!message->getCycleTime().has_value() && msgGlobalCycleTime != 0) {
+            message->setCycleTime(msgGlobalCycleTime);
+        }
+    }
+    metrics->setMessageIds(messageIds);
+    isEmptyLibrary = false;
+}
+
+// Index the file without parsing any signals. Messages get their header parsed and a range of
+// signal handles reserved, VAL_, SIG_VALTYPE_ and BA_ "GenSigStartValue" lines are only
+// remembered for their message. Everything else is parsed as usual
+void DbcParser::indexFromFile(std::istream& in) {
+    DBC_TRACE_SCOPE("parse.index");
+    in.seekg(0, std::ios::end);
+    std::streamoff fileSize = in.tellg();
+    if (fileSize < 0) {
+        // Not seekable, e.g. a pipe, so the size is unknown: read it to the end instead
+        in.clear();
+        databaseText.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    else {
+        in.seekg(0, std::ios::beg);
+        databaseText.resize(static_cast<size_t>(fileSize));
+        in.read(databaseText.data(), fileSize);
+    }
+    const char* text = databaseText.data();
+    const char* textEnd = text + databaseText.size();
+    SignalHandle nextHandle = 0;
+    bool isInNewSymbols = false;
+    const char* lineBegin = text;
+    while (lineBegin < textEnd) {
+        const char* lineEnd = findLineEnd(lineBegin, textEnd);
+        const char* nextLine = lineEnd + (lineEnd < textEnd ? 1 : 0);
+        const char* keywordEnd = lineBegin;
+        std::string_view keyword = firstWord(lineBegin, lineEnd, keywordEnd);
+        if (isInNewSymbols) {
+            // The NS_ section lists keywords, skip it like loadAndParseFromFile does
+            isInNewSymbols = !(keyword == "BS_:" || keyword == "BS_");
+        }
+        else if (keyword == "NS_") {
+            isInNewSymbols = true;
+        }
+        else if (keyword == "BO_") {
+            // Count the SG_ lines of the message to reserve its signal handles
+            SignalHandle signalCount = 0;
+            const char* bodyEnd = lineEnd;
+            const char* scan = nextLine;
+            while (scan < textEnd) {
+                const char* scanEnd = findLineEnd(scan, textEnd);
+                const char* wordEnd = scan;
+                std::string_view word = firstWord(scan, scanEnd, wordEnd);
+                if (word == "SG_") {
+                    // The name is looked up in the text itself, it stays in the arena
+                    const char* nameEnd = wordEnd;
+                    signalNamesByHandle.push_back(firstWord(wordEnd, scanEnd, nameEnd));
+                    // The unit is the first quoted text of the line, as in operator>> for Signal
+                    const char* unitBegin = std::find(nameEnd, scanEnd, '\"');
+                    const char* unitEnd = unitBegin == scanEnd ? scanEnd : std::find(unitBegin + 1, scanEnd, '\"');
+                    signalUnitsByHandle.push_back(unitEnd == scanEnd ? std::string_view()
+                        : std::string_view(unitBegin + 1, static_cast<size_t>(unitEnd - unitBegin - 1)));
+                    signalCount++;
+                    bodyEnd = scanEnd;
                 }
-                else {
-                    databaseBusType = BusType::Unknown;
-                    throw std::invalid_argument("Parse Failed. Unknown bus type.");
+                else if (!word.empty()) {
+                    break;
                 }
+                scan = scanEnd + (scanEnd < textEnd ? 1 : 0);
+            }
+            // Parse the header only
+            std::istringstream header(std::string(keywordEnd, lineEnd));
+            Message msg(messageLibrary.get_allocator());
+            header >> msg;
+            auto inserted = messageLibrary.try_emplace(msg.getId(), std::move(msg));
+            if (!inserted.second) {
+                throw std::invalid_argument("Parse Failed. Message \""
+                    + msg.getName()
+                    + "\" has a duplicate.");
+            }
+            inserted.first->second.setIndex(static_cast<unsigned int>(messagesInfo.size()));
+            messagesInfo.push_back(&(inserted.first->second));
+            LazyMessage& lazy = lazyMessages.emplace_back(arena.get());
+            lazy.bodyBegin = static_cast<size_t>(lineBegin - text);
+            lazy.bodyEnd = static_cast<size_t>(bodyEnd - text);
+            lazy.firstHandle = nextHandle;
+            lazy.signalCount = signalCount;
+            nextHandle += signalCount;
+            nextLine = bodyEnd + (bodyEnd < textEnd ? 1 : 0);
+        }
+        else if (keyword == "VAL_" || keyword == "SIG_VALTYPE_") {
+            unsigned long messageId = std::strtoul(keywordEnd, nullptr, 10);
+            // VAL_ lines without a message ID describe environment variables
+            if (messageId != 0 || keyword == "SIG_VALTYPE_") {
+                addReferenceLine(messageId, lineBegin, lineEnd, keyword == "VAL_"
+                    ? ") for a given signal value description."
+                    : ") for a given signal value type attribute.");
             }
-            // Signal specific initial values
+        }
+        else if (keyword == "BA_") {
+            std::istringstream line(std::string(keywordEnd, lineEnd));
+            std::string attributeName;
+            getline(line, attributeName, '\"');
+            getline(line, attributeName, '\"');
             if (attributeName == "GenSigStartValue") {
+                // Signal specific initial values are parsed together with their message
                 std::string objectType;
-                in >> objectType;
+                line >> objectType;
                 if (objectType == "SG_") {
-                    unsigned int messageId;
-                    in >> messageId;
-                    messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
-                    if (messages_itr != messageLibrary.end()) {
-                        messages_itr->second.parseSigInitialValue(in);
-                    }
-                    else {
-                        throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
-                            + std::to_string(messageId)
-                            + ") for a given signal value description.");
-                    }
+                    unsigned long messageId;
+                    line >> messageId;
+                    addReferenceLine(messageId, lineBegin, lineEnd, ") for a given signal value description.");
                 }
             }
-        }
-        // Additional signal value type
-        else if (lineInitial == "SIG_VALTYPE_") {
-            unsigned int messageId;
-            in >> messageId;
-            messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
-            if (messages_itr != messageLibrary.end()) {
-                messages_itr->second.parseAdditionalSigValueType(in);
-            }
             else {
-                throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
-                    + std::to_string(messageId)
-                    + ") for a given signal value type attribute.");
+                line.seekg(0);
+                parseStatement("BA_", line);
             }
         }
+        else if (keyword == "BA_DEF_" || keyword == "BA_DEF_DEF_") {
+            std::istringstream line(std::string(keywordEnd, lineEnd));
+            parseStatement(std::string(keyword), line);
+        }
+        lineBegin = nextLine;
+    }
+    signalsByHandle.assign(nextHandle, std::make_pair(nullptr, nullptr));
+    for (size_t i = 0; i < lazyMessages.size(); i++) {
+        for (SignalHandle handle = 0; handle < lazyMessages[i].signalCount; handle++) {
+            signalsByHandle[lazyMessages[i].firstHandle + handle].first = messagesInfo[i];
+        }
+    }
+    finishLoading();
+}
+
+void DbcParser::addReferenceLine(unsigned long messageId, const char* lineBegin, const char* lineEnd,
+    const char* errorMessageEnd) {
+    messageLibrary_iterator messages_itr = messageLibrary.find(messageId);
+    if (messages_itr == messageLibrary.end()) {
+        throw std::invalid_argument("Parse Failed. Cannot find message (ID: "
+            + std::to_string(messageId)
+            + errorMessageEnd);
+    }
+    const char* text = databaseText.data();
+    lazyMessages[messages_itr->second.getIndex()].referenceLines.emplace_back(
+        static_cast<size_t>(lineBegin - text), static_cast<size_t>(lineEnd - text));
+}
+
+void DbcParser::ensureMessageParsed(unsigned int messageIndex) const {
+    if (loadMode == LoadMode::Lazy) {
+        const LazyMessage& lazy = lazyMessages[messageIndex];
+        if (lazy.isFailed.load(std::memory_order_acquire)) {
+            throw std::invalid_argument(lazy.failureMessage);
+        }
+        std::call_once(lazyMessages[messageIndex].isParsed, &DbcParser::parseMessageBody, this, messageIndex);
+    }
+}
+
+bool DbcParser::tryEnsureMessageParsed(unsigned int messageIndex) const {
+    // A message that already failed is reported without parsing or throwing again
+    if (loadMode == LoadMode::Lazy && lazyMessages[messageIndex].isFailed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    try {
+        ensureMessageParsed(messageIndex);
+        return true;
+    }
+    catch (std::exception&) {
+        return false;
+    }
+}
+
+// Parse the signals of a lazily loaded message and apply the lines that refer to it
+// Runs once per message, see ensureMessageParsed(). A failure is latched in the LazyMessage
+void DbcParser::parseMessageBody(unsigned int messageIndex) const {
+    // The arena is not thread safe, so messages are parsed one at a time
+    std::lock_guard<std::mutex> lock(*lazyParseMutex);
+    LazyMessage& lazy = lazyMessages[messageIndex];
+    // Another thread may have failed on this message while this one waited for the lock
+    if (lazy.isFailed.load(std::memory_order_relaxed)) {
+        throw std::invalid_argument(lazy.failureMessage);
+    }
+    try {
+        parseMessageBodyLocked(messageIndex);
+    }
+    catch (std::exception& e) {
+        lazy.failureMessage = e.what();
+        lazy.isFailed.store(true, std::memory_order_release);
+        throw;
+    }
+}
+
+void DbcParser::parseMessageBodyLocked(unsigned int messageIndex) const {
+    DBC_TRACE_SCOPE("parse.messageBody");
+    const LazyMessage& lazy = lazyMessages[messageIndex];
+    const char* text = databaseText.data();
+    std::istringstream body(std::string(text + lazy.bodyBegin, text + lazy.bodyEnd));
+    std::string keyword;
+    body >> keyword;
+    // Parsed aside and moved in at the end, so a failed parse leaves the message untouched
+    Message parsed(messageLibrary.get_allocator());
+    body >> parsed;
+    for (auto& lineRange : lazy.referenceLines) {
+        std::istringstream line(std::string(text + lineRange.first, text + lineRange.second));
+        unsigned long messageId;
+        line >> keyword;
+        if (keyword == "VAL_") {
+            line >> messageId;
+            parsed.parseSigValueDescription(line);
+        }
+        else if (keyword == "SIG_VALTYPE_") {
+            line >> messageId;
+            parsed.parseAdditionalSigValueType(line);
+        }
         else {
-            // Reserved cases for parsing other info in the DBC file
+            // BA_ "GenSigStartValue" SG_
+            std::string attributeName;
+            getline(line, attributeName, '\"');
+            getline(line, attributeName, '\"');
+            line >> attributeName >> messageId;
+            parsed.parseSigInitialValue(line);
         }
-        // Skip the rest of the line for uninterested data
-        // Make sure we can get a whole new line in the next iteration
-        in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
-    isEmptyLibrary = false;
+    if (parsed.getSignals().size() != lazy.signalCount) {
+        throw std::invalid_argument("Parse Failed. Signals of message \""
+            + parsed.getName()
+            + "\" could not be parsed.");
+    }
+    parsed.assignSignalHandles(lazy.firstHandle);
+    checkSignalConsistency(parsed);
+    parsed.analyzeLayout(layoutIssues);
+    Message& msg = *messagesInfo[messageIndex];
+    // Same allocator, so the signal nodes are moved over and keep their addresses
+    msg.moveSignalsFrom(std::move(parsed));
+    for (auto& sig : msg.getSignals()) {
+        signalsByHandle[sig.second.getHandle()].second = &sig.second;
+    }
+}
+
+// Handles follow message order, then signal order within each message
+void DbcParser::assignSignalHandles() {
+    SignalHandle nextHandle = 0;
+    for (auto message : messagesInfo) {
+        nextHandle = message->assignSignalHandles(nextHandle);
+    }
+    signalsByHandle.assign(nextHandle, std::make_pair(nullptr, nullptr));
+    for (auto message : messagesInfo) {
+        for (auto& sig : message->getSignals()) {
+            signalsByHandle[sig.second.getHandle()] = std::make_pair(message, &sig.second);
+        }
+    }
+}
+
+void DbcParser::buildSignalNameIndex() {
+    // Lazy loading collects the names and units while indexing, before any signal is parsed
+    if (loadMode == LoadMode::Full) {
+        signalNamesByHandle.clear();
+        signalUnitsByHandle.clear();
+        for (auto& entry : signalsByHandle) {
+            signalNamesByHandle.push_back(entry.second->getNameView());
+            signalUnitsByHandle.push_back(entry.second->getUnitView());
+        }
+    }
+    signalNameIndex.resize(signalNamesByHandle.size());
+    for (SignalHandle handle = 0; handle < signalNameIndex.size(); handle++) {
+        signalNameIndex[handle] = handle;
+    }
+    // Signals of the same name stay in handle order
+    std::stable_sort(signalNameIndex.begin(), signalNameIndex.end(),
+        [this](SignalHandle lhs, SignalHandle rhs) {
+            return signalNamesByHandle[lhs] < signalNamesByHandle[rhs];
+        });
+}
+
+std::span<const SignalHandle> DbcParser::findSignals(std::string_view sigName) const {
+    auto range = std::equal_range(signalNameIndex.begin(), signalNameIndex.end(), sigName,
+        SignalNameLess{ signalNamesByHandle });
+    return std::span<const SignalHandle>(signalNameIndex.data() + (range.first - signalNameIndex.begin()),
+        static_cast<size_t>(range.second - range.first));
+}
+
+std::optional<SignalHandle> DbcParser::findSignal(std::string_view sigName) const {
+    std::span<const SignalHandle> handles = findSignals(sigName);
+    if (handles.size() != 1) {
+        return std::nullopt;
+    }
+    return handles.front();
+}
+
+void DbcParser::buildPgnLibrary() {
+    for (auto message : messagesInfo) {
+        if (message->getId() & CAN_ID_EXTENDED_FLAG) {
+            // Keeps the first message if a PGN is defined more than once
+            pgnLibrary.emplace(decomposeJ1939Id(message->getId()).pgn, message);
+        }
+    }
+}
+
+const Message* DbcParser::getMessage(unsigned long msgId) const {
+    auto data_itr_msg = messageLibrary.find(msgId);
+    if (data_itr_msg == messageLibrary.end()) {
+        return nullptr;
+    }
+    ensureMessageParsed(data_itr_msg->second.getIndex());
+    return &data_itr_msg->second;
+}
+
+const Message* DbcParser::getMessageByPgn(uint32_t pgn) const {
+    auto pgn_itr = pgnLibrary.find(pgn);
+    if (pgn_itr == pgnLibrary.end()) {
+        return nullptr;
+    }
+    ensureMessageParsed(pgn_itr->second->getIndex());
+    return pgn_itr->second;
+}
+
+std::optional<SignalHandle> DbcParser::getSignalHandle(unsigned long msgId, std::string_view sigName) const {
+    // Signal names are unique within a message, so at most one of the handles matches
+    for (SignalHandle handle : findSignals(sigName)) {
+        if (signalsByHandle[handle].first->getId() == msgId) {
+            return handle;
+        }
+    }
+    return std::nullopt;
+}
+
+size_t DbcParser::getDecodedSignalCount(unsigned long msgId, unsigned int msgSize) const {
+    const Message* message = findMessage(msgId, j1939Mode);
+    if (message == nullptr || msgSize != message->getDlc()) {
+        return 0;
+    }
+    if (loadMode == LoadMode::Lazy) {
+        return lazyMessages[message->getIndex()].signalCount;
+    }
+    return message->getSignals().size();
+}
+
+std::vector<std::pair<unsigned long, unsigned int> > DbcParser::getCyclicMessages() const {
+    std::vector<std::pair<unsigned long, unsigned int> > cyclicMessages;
+    for (auto message : messagesInfo) {
+        if (message->getCycleTime().value_or(0) != 0) {
+            cyclicMessages.emplace_back(message->getId(), message->getCycleTime().value());
+        }
+    }
+    return cyclicMessages;
+}
+
+const Signal* DbcParser::getSignal(SignalHandle handle) const {
+    if (handle >= signalsByHandle.size()) {
+        return nullptr;
+    }
+    ensureMessageParsed(signalsByHandle[handle].first->getIndex());
+    return signalsByHandle[handle].second;
+}
+
+const Message* DbcParser::getMessageOfSignal(SignalHandle handle) const {
+    if (handle >= signalsByHandle.size()) {
+        return nullptr;
+    }
+    ensureMessageParsed(signalsByHandle[handle].first->getIndex());
+    return signalsByHandle[handle].first;
+}
+
+std::string_view DbcParser::getSignalName(SignalHandle handle) const {
+    return handle < signalNamesByHandle.size() ? signalNamesByHandle[handle] : std::string_view();
+}
+
+std::string_view DbcParser::getSignalUnit(SignalHandle handle) const {
+    return handle < signalUnitsByHandle.size() ? signalUnitsByHandle[handle] : std::string_view();
+}
+
+std::optional<unsigned long> DbcParser::getMessageIdOfSignal(SignalHandle handle) const {
+    if (handle >= signalsByHandle.size()) {
+        return std::nullopt;
+    }
+    // The message header is there from the start, only its signals are parsed lazily
+    return signalsByHandle[handle].first->getId();
+}
+
+unsigned short DbcParser::getMaxMessageLength() const {
+    if (databaseBusType == BusType::CAN) {
+        return MAX_MSG_LEN_CAN;
+    }
+    else if (databaseBusType == BusType::CAN_FD) {
+        return MAX_MSG_LEN_CAN_FD;
+    }
+    return 0;
 }
 
 // Load file from path. Parse and store the content
 // A returned bool is used to indicate whether parsing succeeds or not
-bool DbcParser::parse(const std::string& filePath) {
+bool DbcParser::parse(const std::string& filePath, LoadMode mode) {
     // Get file path, open the file stream
     std::ifstream dbcFile(filePath.c_str(), std::ios::binary);
-    if (dbcFile) {
-        // Parse file content
-        loadAndParseFromFile(dbcFile);
-    }
-    else {
+    if (!dbcFile) {
         throw std::invalid_argument("Parse Failed. Could not open CAN database file.");
         return false;
     }
-    consistencyCheck();
+    // Parse file content
+    bool isParsed = parse(dbcFile, mode);
     dbcFile.close();
+    return isParsed;
+}
+
+bool DbcParser::parse(std::istream& in, LoadMode mode) {
+    LatencyTimer timer(*metrics, MetricsOperation::Parse);
+    DBC_TRACE_SCOPE("parse");
+    loadMode = mode;
+    if (mode == LoadMode::Lazy) {
+        indexFromFile(in);
+    }
+    else {
+        loadAndParseFromFile(in);
+    }
+    consistencyCheck();
     return true;
 }
 
 void DbcParser::consistencyCheck() {
+    DBC_TRACE_SCOPE("parse.consistencyCheck");
     if (!((sigGlobalInitialValue <= sigGlobalInitialValueMax)
         && (sigGlobalInitialValue >= sigGlobalInitialValueMin))
         && !(sigGlobalInitialValueMax == 0 && sigGlobalInitialValueMin == 0)) {
         throw std::invalid_argument("<Consistency check> "
             "Default signal initial value is not within its min and max range.");
     }
-    for (auto message : messageLibrary) {
-        for (auto& sig : message.second.getSignalsInfo()) {
-            if (sig.second.getInitialValue().has_value()) {
-                if (!((sig.second.getInitialValue().value() <= sig.second.getMaxValue())
-                    && (sig.second.getInitialValue().value() >= sig.second.getMinValue()))) {
-                    // Refer to attribute BA_ "GenSigStartValue" SG_ in DBC file
-                    throw std::invalid_argument("<Consistency check> "
-                        "Signal initial value is not within min and max range of signal \""
-                        + sig.second.getName() + "\".");
-                }
+    // Lazily loaded messages are checked when they are parsed
+    if (loadMode == LoadMode::Full) {
+        for (auto& message : messageLibrary) {
+            checkSignalConsistency(message.second);
+        }
+        // In DBC file order, so the issues are reported in a stable order
+        for (auto message : messagesInfo) {
+            message->analyzeLayout(layoutIssues);
+        }
+    }
+}
+
+std::vector<LayoutIssue> DbcParser::getLayoutIssues() const {
+    std::lock_guard<std::mutex> lock(*lazyParseMutex);
+    return layoutIssues;
+}
+
+void DbcParser::checkSignalConsistency(const Message& message) const {
+    for (auto& sig : message.getSignals()) {
+        if (sig.second.getInitialValue().has_value()) {
+            if (!((sig.second.getInitialValue().value() <= sig.second.getMaxValue())
+                && (sig.second.getInitialValue().value() >= sig.second.getMinValue()))) {
+                // Refer to attribute BA_ "GenSigStartValue" SG_ in DBC file
+                throw std::invalid_argument("<Consistency check> "
+                    "Signal initial value is not within min and max range of signal \""
+                    + sig.second.getName() + "\".");
             }
-            else {
-                if (!((sigGlobalInitialValue <= sig.second.getMaxValue())
-                    && (sigGlobalInitialValue >= sig.second.getMinValue()))) {
-                    // Refer to attribute BA_DEF_DEF_  "GenSigStartValue" in DBC file
-                    // This value should usually be 0 to avoid this warning
-                    throw std::invalid_argument("<Consistency check> "
-                        "Global signal initial value is not within min and max range of signal \""
-                        + sig.second.getName() + "\".");
-                }
+        }
+        else {
+            if (!((sigGlobalInitialValue <= sig.second.getMaxValue())
+                && (sigGlobalInitialValue >= sig.second.getMinValue()))) {
+                // Refer to attribute BA_DEF_DEF_  "GenSigStartValue" in DBC file
+                // This value should usually be 0 to avoid this warning
+                throw std::invalid_argument("<Consistency check> "
+                    "Global signal initial value is not within min and max range of signal \""
+                    + sig.second.getName() + "\".");
             }
         }
     }
@@ -274,24 +788,35 @@ std::unordered_map<std::string, double> DbcParser::decode(
     unsigned long msgId,
     unsigned int msgSize,
     unsigned char payload[]) {
+    LatencyTimer timer(*metrics, MetricsOperation::Decode);
+    DBC_TRACE_SCOPE("decode");
     std::unordered_map<std::string, double> result;
-    messageLibrary_iterator data_itr_msg = messageLibrary.find(msgId);
-    if (data_itr_msg == messageLibrary.end()) {
+    const Message* message = findMessage(msgId, j1939Mode);
+    if (message == nullptr) {
+        metrics->countUnknownId();
         std::cerr << "Decode failed. "
             << "No matching message found. "
             << "An empty result is returned."
             << std::endl;
     }
     else {
+        ensureMessageParsed(message->getIndex());
+        if (msgSize != message->getDlc()) {
+            metrics->countDlcMismatch();
+        }
         if (databaseBusType == BusType::CAN) {
-            result = messageLibrary[msgId].decode(payload,
-                MAX_MSG_LEN_CAN,
-                msgSize);
+            message->decodeSignals(payload, MAX_MSG_LEN_CAN, msgSize,
+                [&result](const Signal& sig, double value) {
+                    result.insert(std::make_pair(sig.getName(), value));
+                });
+            metrics->countDecoded(message->getIndex());
         }
         else if (databaseBusType == BusType::CAN_FD) {
-            result = messageLibrary[msgId].decode(payload,
-                MAX_MSG_LEN_CAN_FD,
-                msgSize);
+            message->decodeSignals(payload, MAX_MSG_LEN_CAN_FD, msgSize,
+                [&result](const Signal& sig, double value) {
+                    result.insert(std::make_pair(sig.getName(), value));
+                });
+            metrics->countDecoded(message->getIndex());
         }
         else {
             std::cerr << "Decode failed. "
@@ -302,37 +827,148 @@ std::unordered_map<std::string, double> DbcParser::decode(
     return result;
 }
 
+CodecStatus DbcParser::tryDecode(
+    unsigned long msgId,
+    unsigned int msgSize,
+    unsigned char const payload[],
+    std::unordered_map<std::string, double>& result) const {
+    result.clear();
+    return tryDecodeSignals(msgId, msgSize, payload,
+        [&result](const Signal& sig, double value) {
+            result[sig.getName()] = value;
+        });
+}
+
+CodecStatus DbcParser::tryDecodeJ1939(
+    unsigned long msgId,
+    unsigned int msgSize,
+    unsigned char const payload[],
+    std::unordered_map<std::string, double>& result,
+    J1939Id& j1939Id) const {
+    result.clear();
+    return tryDecodeJ1939Signals(msgId, msgSize, payload, j1939Id,
+        [&result](const Signal& sig, double value) {
+            result[sig.getName()] = value;
+        });
+}
+
+template <typename SignalValueAt>
+CodecStatus DbcParser::tryEncodeMessage(
+    unsigned long msgId,
+    size_t signalCount,
+    SignalValueAt&& signalValueAt,
+    unsigned char encodedPayload[],
+    unsigned int encodedPayloadSize,
+    unsigned int& encodedMsgSize) const {
+    LatencyTimer timer(*metrics, MetricsOperation::Encode);
+    DBC_TRACE_SCOPE("encode");
+    encodedMsgSize = 0;
+    auto data_itr_msg = messageLibrary.find(msgId);
+    if (data_itr_msg == messageLibrary.end()) {
+        metrics->countUnknownId();
+        return CodecStatus::UnknownMessage;
+    }
+    if (getMaxMessageLength() == 0) {
+        return CodecStatus::UnknownBusType;
+    }
+    const Message& message = data_itr_msg->second;
+    if (!tryEnsureMessageParsed(message.getIndex())) {
+        return CodecStatus::InvalidDefinition;
+    }
+    unsigned int outOfRangeCount = 0;
+    CodecStatus status = message.tryEncodeSignals(signalCount,
+        [&message, &signalValueAt](size_t i) { return signalValueAt(message, i); },
+        encodedPayload,
+        encodedPayloadSize,
+        sigGlobalInitialValue,
+        outOfRangeCount);
+    if (status == CodecStatus::UnknownSignal) {
+        metrics->countUnknownSignal();
+    }
+    if (status == CodecStatus::Ok || status == CodecStatus::ValueOutOfRange) {
+        metrics->countEncoded();
+        metrics->countOutOfRange(outOfRangeCount);
+        encodedMsgSize = message.getDlc();
+    }
+    return status;
+}
+
+CodecStatus DbcParser::tryEncode(
+    unsigned long msgId,
+    const std::vector<std::pair<std::string, double> >& signalsToEncode,
+    unsigned char encodedPayload[],
+    unsigned int encodedPayloadSize,
+    unsigned int& encodedMsgSize) const {
+    return tryEncodeMessage(msgId, signalsToEncode.size(),
+        [&signalsToEncode](const Message& message, size_t i) {
+            auto signals_itr = message.getSignals().find(signalsToEncode[i].first);
+            const Signal* sig = signals_itr == message.getSignals().end() ? nullptr : &signals_itr->second;
+            return std::pair<const Signal*, double>(sig, signalsToEncode[i].second);
+        },
+        encodedPayload, encodedPayloadSize, encodedMsgSize);
+}
+
+CodecStatus DbcParser::tryEncode(
+    unsigned long msgId,
+    SignalHandle const handles[],
+    double const physicalValues[],
+    size_t signalCount,
+    unsigned char encodedPayload[],
+    unsigned int encodedPayloadSize,
+    unsigned int& encodedMsgSize) const {
+    return tryEncodeMessage(msgId, signalCount,
+        [this, handles, physicalValues](const Message& message, size_t i) {
+            SignalHandle handle = handles[i];
+            // Handles of other messages count as unknown signals
+            const Signal* sig = nullptr;
+            if (handle < signalsByHandle.size() && signalsByHandle[handle].first == &message) {
+                sig = signalsByHandle[handle].second;
+            }
+            return std::pair<const Signal*, double>(sig, physicalValues[i]);
+        },
+        encodedPayload, encodedPayloadSize, encodedMsgSize);
+}
+
 unsigned int DbcParser::encode(
     unsigned long msgId,
     std::vector<std::pair<std::string, double> >& signalsToEncode,
     unsigned char encodedPayload[],
     unsigned int encodedPayloadSize) {
 
+    LatencyTimer timer(*metrics, MetricsOperation::Encode);
+    DBC_TRACE_SCOPE("encode");
     // Find the message and encode based on bus type
     unsigned int msgSize = 0;
+    unsigned int outOfRangeCount = 0;
     messageLibrary_iterator data_itr_msg = messageLibrary.find(msgId);
     if (data_itr_msg == messageLibrary.end()) {
+        metrics->countUnknownId();
         std::cerr << "Encode failed. No matching message found."
             << "An empty result is returned." << std::endl;
     }
     else {
+        ensureMessageParsed(data_itr_msg->second.getIndex());
         if (databaseBusType == BusType::CAN) {
             msgSize = messageLibrary[msgId].encode(signalsToEncode,
                 encodedPayload,
                 encodedPayloadSize,
-                sigGlobalInitialValue);
+                sigGlobalInitialValue,
+                &outOfRangeCount);
         }
         else if (databaseBusType == BusType::CAN_FD) {
             msgSize = messageLibrary[msgId].encode(signalsToEncode,
                 encodedPayload,
                 encodedPayloadSize,
-                sigGlobalInitialValue);
+                sigGlobalInitialValue,
+                &outOfRangeCount);
         }
         else {
             std::cerr << "Encode failed. Unknown bus type."
                 << "An empty result is returned." << std::endl;
             return msgSize;
         }
+        metrics->countEncoded();
+        metrics->countOutOfRange(outOfRangeCount);
     }
     if (msgSize > encodedPayloadSize) {
         std::cerr << "The provided array size is smaller than message size "
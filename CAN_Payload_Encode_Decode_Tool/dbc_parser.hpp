@@ -10,13 +10,37 @@
 
 #include <iosfwd>
 #include <string>
+#include <utility>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <span>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <memory_resource>
+#include <stdexcept>
 #include <sstream>
 #include <vector>
 #include <unordered_map>
+#include "dbc_parser_dependencies/j1939.hpp"
 #include "dbc_parser_dependencies/message.hpp"
+#include "dbc_parser_dependencies/runtime_metrics.hpp"
+#include "dbc_parser_dependencies/trace.hpp"
 
 constexpr unsigned short MAX_MSG_LEN_CAN = 8;
 constexpr unsigned short MAX_MSG_LEN_CAN_FD = 64;
+// Bit 31 marks extended (29-bit) IDs, the same way DBC files store them
+constexpr unsigned long CAN_ID_EXTENDED_FLAG = 0x80000000UL;
+// Size of the first block of the database arena, later blocks grow geometrically
+constexpr size_t DATABASE_ARENA_BLOCK_SIZE = 64 * 1024;
+
+enum class LoadMode {
+    // Parse the whole file up front
+    Full,
+    // Only index message headers up front, the signals of a message are parsed when it is first used
+    Lazy
+};
 
 enum class BusType {
     NotSet,
@@ -31,13 +55,54 @@ public:
 
     // Construct using either a File or a Stream of a DBC-File
     // A bool is used to indicate whether parsing succeeds or not
-    bool parse(const std::string& filePath);
+    // In LoadMode::Lazy, parse errors inside a message are only found when the message is first used
+    bool parse(const std::string& filePath, LoadMode mode = LoadMode::Full);
+    // Same for DBC content that is already in memory, or any other stream
+    bool parse(std::istream& in, LoadMode mode = LoadMode::Full);
     // Decode
     std::unordered_map<std::string, double> decode(
         unsigned long msgId,
         unsigned int msgSize,
         unsigned char payLoad[]
     );
+    // Decode without building a result map. The visitor is called as
+    // visitor(const Signal&, double physicalValue) once for every signal of the message
+    // Returns false if the message is unknown or the bus type is not set
+    template <typename SignalVisitor>
+    bool decodeSignals(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        SignalVisitor&& visitor
+    ) const {
+        CodecStatus status = tryDecodeSignals(msgId, msgSize, payload, std::forward<SignalVisitor>(visitor));
+        if (status == CodecStatus::DlcMismatch) {
+            throw std::invalid_argument("Decode failed. "
+                "The data length of the input payload does not match with DBC info.");
+        }
+        return status == CodecStatus::Ok;
+    }
+    // Non-throwing, non-logging decode for the per-frame path
+    // Failures are reported through the returned status and counted in the runtime metrics
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeSignals(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        SignalVisitor&& visitor
+    ) const {
+        LatencyTimer timer(*metrics, MetricsOperation::Decode);
+        DBC_TRACE_SCOPE("decode");
+        return tryDecodeMessage(findMessage(msgId, j1939Mode), msgSize, payload,
+            std::forward<SignalVisitor>(visitor));
+    }
+    // Same as decode(), but result is cleared and filled in place so its buckets can be reused
+    CodecStatus tryDecode(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        std::unordered_map<std::string, double>& result
+    ) const;
     // Encode
     unsigned int encode(
         unsigned long msgId,
@@ -45,24 +110,239 @@ public:
         unsigned char encodedPayload[],
         unsigned int encodedPayloadSize
     );
+    // Non-throwing, non-logging encode. encodedMsgSize receives the message size on success
+    // Out of range values are encoded with their initial value and reported as
+    // CodecStatus::ValueOutOfRange, the payload is still valid in that case
+    CodecStatus tryEncode(
+        unsigned long msgId,
+        const std::vector<std::pair<std::string, double> >& signalsToEncode,
+        unsigned char encodedPayload[],
+        unsigned int encodedPayloadSize,
+        unsigned int& encodedMsgSize
+    ) const;
+    // Same as tryEncode() above, with physicalValues[i] for the signal with handles[i]
+    // Handles of signals of other messages fail with CodecStatus::UnknownSignal
+    CodecStatus tryEncode(
+        unsigned long msgId,
+        SignalHandle const handles[],
+        double const physicalValues[],
+        size_t signalCount,
+        unsigned char encodedPayload[],
+        unsigned int encodedPayloadSize,
+        unsigned int& encodedMsgSize
+    ) const;
+    // J1939 decode. Extended IDs that are not in the database are looked up by their PGN,
+    // so a message is found whatever address it is sent from. The source address, destination
+    // address and priority of the frame are reported in j1939Id. Works with J1939 mode on or off
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeJ1939Signals(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        J1939Id& j1939Id,
+        SignalVisitor&& visitor
+    ) const {
+        LatencyTimer timer(*metrics, MetricsOperation::Decode);
+        DBC_TRACE_SCOPE("decode");
+        j1939Id = decomposeJ1939Id(msgId);
+        return tryDecodeMessage(findMessage(msgId, true), msgSize, payload,
+            std::forward<SignalVisitor>(visitor));
+    }
+    CodecStatus tryDecodeJ1939(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        std::unordered_map<std::string, double>& result,
+        J1939Id& j1939Id
+    ) const;
+    // In J1939 mode decode(), tryDecode() and tryDecodeSignals() fall back to the PGN lookup as well
+    // parse() turns it on when the database has the attribute BA_ "ProtocolType" "J1939"
+    void setJ1939Mode(bool enabled) { j1939Mode = enabled; }
+    bool isJ1939Mode() const { return j1939Mode; }
+    // Message with exactly this ID, nullptr if there is none
+    const Message* getMessage(unsigned long msgId) const;
+    // Message defined for a PGN, nullptr if there is none. If the database defines the same PGN
+    // for several source addresses, the first one in the file is used
+    const Message* getMessageByPgn(uint32_t pgn) const;
+    // <Message id, cycle time in ms> of all messages with a GenMsgCycleTime, in DBC file order
+    // Does not parse lazily loaded messages
+    std::vector<std::pair<unsigned long, unsigned int> > getCyclicMessages() const;
+    // Signals that overlap another signal or reach past the DLC of their message, found while
+    // parsing. In lazy mode only messages that have been parsed so far are included
+    std::vector<LayoutIssue> getLayoutIssues() const;
+    // Signal handles are dense indices in [0, getSignalCount()), in DBC file order
+    SignalHandle getSignalCount() const { return static_cast<SignalHandle>(signalsByHandle.size()); }
+    // Looks up the signal name index, so it neither allocates nor parses lazily loaded messages
+    std::optional<SignalHandle> getSignalHandle(unsigned long msgId, std::string_view sigName) const;
+    // Number of signals tryDecodeSignals() passes to its visitor for this frame, 0 if the ID is
+    // unknown or msgSize does not match the DLC. Does not parse lazily loaded messages
+    size_t getDecodedSignalCount(unsigned long msgId, unsigned int msgSize) const;
+    // Find signals by name alone, without knowing their message. Looks up a sorted index
+    // built while parsing, no message is searched and lazily loaded messages are not parsed
+    // Handles of all signals with this name, in ascending order. Several handles mean the name is ambiguous
+    std::span<const SignalHandle> findSignals(std::string_view sigName) const;
+    // The signal with this name, empty if there is none or if several messages have one
+    std::optional<SignalHandle> findSignal(std::string_view sigName) const;
+    bool isAmbiguousSignalName(std::string_view sigName) const { return findSignals(sigName).size() > 1; }
+    // Returns nullptr if the handle is out of range
+    const Signal* getSignal(SignalHandle handle) const;
+    const Message* getMessageOfSignal(SignalHandle handle) const;
+    // Name, unit and message ID of a signal, without parsing lazily loaded messages
+    // The views point into the parser. Empty, or no ID, if the handle is out of range
+    std::string_view getSignalName(SignalHandle handle) const;
+    std::string_view getSignalUnit(SignalHandle handle) const;
+    std::optional<unsigned long> getMessageIdOfSignal(SignalHandle handle) const;
+    // Payload buffer length used by the bus type: 8 for CAN, 64 for CAN FD, 0 if unknown
+    unsigned short getMaxMessageLength() const;
+    // Runtime counters of decode/encode calls and, if enabled, latency histograms
+    MetricsSnapshot getMetrics() const { return metrics->snapshot(); }
+    void resetMetrics() { metrics->reset(); }
+    void setLatencyTracking(bool enabled) { metrics->setLatencyTracking(enabled); }
     // Print DBC Info
     friend std::ostream& operator<<(std::ostream& os, const DbcParser& dbcFile);
+    DbcParser() = default;
+    // Moving keeps the arena and everything in it where it is
+    DbcParser(DbcParser&&) = default;
+    DbcParser& operator=(DbcParser&&) = delete;
 
 private:
 
-    typedef std::unordered_map<unsigned long, Message>::iterator messageLibrary_iterator;
+    // Builds its routing table from the message library and decodes through tryDecodeMessage()
+    friend class DbcRegistry;
+    // Counts frames answered from the cache in the runtime metrics, as if they were decoded
+    friend class DecodeCache;
+    typedef std::pmr::unordered_map<unsigned long, Message>::iterator messageLibrary_iterator;
     bool isEmptyLibrary = true; // A bool to indicate whether DBC file has been loaded or not
     double sigGlobalInitialValue; // BA_DEF_DEF_  "GenSigStartValue"
     double sigGlobalInitialValueMin; // BA_DEF_ SG_  "GenSigStartValue"
     double sigGlobalInitialValueMax; // BA_DEF_ SG_  "GenSigStartValue"
+    unsigned int msgGlobalCycleTime = 0; // BA_DEF_DEF_  "GenMsgCycleTime"
     BusType databaseBusType = BusType::NotSet; // CAN or CAN FD
+    // Messages, signals and all their strings and tables are allocated from this arena
+    // and released together with the parser. Declared first, so it outlives the containers
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena =
+        std::make_unique<std::pmr::monotonic_buffer_resource>(DATABASE_ARENA_BLOCK_SIZE);
     // Stores all info of messages. <Message id, Message object>
-    std::unordered_map<unsigned long, Message> messageLibrary;
+    std::pmr::unordered_map<unsigned long, Message> messageLibrary{ arena.get() };
+    // Extended-ID messages by J1939 parameter group number. <PGN, Message>
+    std::pmr::unordered_map<uint32_t, const Message*> pgnLibrary{ arena.get() };
+    bool j1939Mode = false;
     // Contains all the messages which got parsed from the DBC-File
-    std::vector<Message*> messagesInfo;
+    std::pmr::vector<Message*> messagesInfo{ arena.get() };
+    // <Message, Signal> pairs indexed by signal handle
+    // In lazy mode the signal is filled in when its message gets parsed
+    mutable std::pmr::vector<std::pair<const Message*, const Signal*> > signalsByHandle{ arena.get() };
+    LoadMode loadMode = LoadMode::Full;
+    // Names point into the signals, or into databaseText in lazy mode
+    std::pmr::vector<std::string_view> signalNamesByHandle{ arena.get() };
+    std::pmr::vector<std::string_view> signalUnitsByHandle{ arena.get() };
+    // All signal handles, sorted by name and then by handle
+    std::pmr::vector<SignalHandle> signalNameIndex{ arena.get() };
+    struct SignalNameLess {
+        const std::pmr::vector<std::string_view>& names;
+        bool operator()(SignalHandle lhs, std::string_view rhs) const { return names[lhs] < rhs; }
+        bool operator()(std::string_view lhs, SignalHandle rhs) const { return lhs < names[rhs]; }
+    };
+    // Where a lazily loaded message is defined, indexed by message index
+    struct LazyMessage {
+        explicit LazyMessage(std::pmr::memory_resource* resource) : referenceLines(resource) {}
+        std::once_flag isParsed;
+        // Set once the body failed to parse, so a broken message is not parsed again for
+        // every frame. failureMessage is written before the flag and never changes after it
+        std::atomic<bool> isFailed{ false };
+        std::string failureMessage;
+        // Byte range of the BO_ line and its SG_ lines in databaseText
+        size_t bodyBegin = 0;
+        size_t bodyEnd = 0;
+        // Byte ranges of the VAL_, SIG_VALTYPE_ and BA_ "GenSigStartValue" lines of the message
+        std::pmr::vector<std::pair<size_t, size_t> > referenceLines;
+        // Handles are reserved while indexing, so they are the same as with LoadMode::Full
+        SignalHandle firstHandle = 0;
+        SignalHandle signalCount = 0;
+    };
+    // Not in the arena: a moved-from std::deque allocates, which must not outlive the arena
+    mutable std::deque<LazyMessage> lazyMessages;
+    // Behind a pointer so the parser stays movable
+    std::unique_ptr<std::mutex> lazyParseMutex = std::make_unique<std::mutex>();
+    // Filled by Message::analyzeLayout(), guarded by lazyParseMutex in lazy mode
+    mutable std::vector<LayoutIssue> layoutIssues;
+    // Text of the DBC file, kept in lazy mode to parse messages from
+    std::pmr::string databaseText{ arena.get() };
+    // Counters are updated from const decode paths, so they live behind a pointer
+    std::unique_ptr<RuntimeMetrics> metrics = std::make_unique<RuntimeMetrics>();
     // Function used to parse DBC file
     void loadAndParseFromFile(std::istream& in);
+    void parseStatement(const std::string& lineInitial, std::istream& in);
+    void finishLoading();
+    void indexFromFile(std::istream& in);
+    void addReferenceLine(unsigned long messageId, const char* lineBegin, const char* lineEnd,
+        const char* errorMessageEnd);
+    // Parse a lazily loaded message if that did not happen yet. Safe to call from several threads
+    void ensureMessageParsed(unsigned int messageIndex) const;
+    // Same, but returns false instead of throwing if the message cannot be parsed
+    bool tryEnsureMessageParsed(unsigned int messageIndex) const;
+    void parseMessageBody(unsigned int messageIndex) const;
+    // The parse itself, called with lazyParseMutex held
+    void parseMessageBodyLocked(unsigned int messageIndex) const;
     void consistencyCheck();
+    void checkSignalConsistency(const Message& message) const;
+    void assignSignalHandles();
+    // Shared by the tryEncode() overloads. signalValueAt(message, i) returns the i-th
+    // std::pair<const Signal*, double> to encode, nullptr if the signal is unknown
+    template <typename SignalValueAt>
+    CodecStatus tryEncodeMessage(
+        unsigned long msgId,
+        size_t signalCount,
+        SignalValueAt&& signalValueAt,
+        unsigned char encodedPayload[],
+        unsigned int encodedPayloadSize,
+        unsigned int& encodedMsgSize
+    ) const;
+    void buildPgnLibrary();
+    void buildSignalNameIndex();
+    // Exact ID match first, then the PGN of an extended ID if usePgn is set
+    const Message* findMessage(unsigned long msgId, bool usePgn) const {
+        auto data_itr_msg = messageLibrary.find(msgId);
+        if (data_itr_msg != messageLibrary.end()) {
+            return &data_itr_msg->second;
+        }
+        if (usePgn && (msgId & CAN_ID_EXTENDED_FLAG)) {
+            auto pgn_itr = pgnLibrary.find(decomposeJ1939Id(msgId).pgn);
+            if (pgn_itr != pgnLibrary.end()) {
+                return pgn_itr->second;
+            }
+        }
+        return nullptr;
+    }
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeMessage(
+        const Message* message,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        SignalVisitor&& visitor
+    ) const {
+        if (message == nullptr) {
+            metrics->countUnknownId();
+            return CodecStatus::UnknownMessage;
+        }
+        if (!tryEnsureMessageParsed(message->getIndex())) {
+            return CodecStatus::InvalidDefinition;
+        }
+        unsigned short maxMsgLen = getMaxMessageLength();
+        if (maxMsgLen == 0) {
+            return CodecStatus::UnknownBusType;
+        }
+        // Everything in "decode" outside of this span is the message lookup
+        DBC_TRACE_SCOPE("decode.signals");
+        CodecStatus status = message->tryDecodeSignals(payload, maxMsgLen, msgSize,
+            std::forward<SignalVisitor>(visitor));
+        if (status == CodecStatus::DlcMismatch) {
+            metrics->countDlcMismatch();
+            return status;
+        }
+        metrics->countDecoded(message->getIndex());
+        return status;
+    }
 
 };
 
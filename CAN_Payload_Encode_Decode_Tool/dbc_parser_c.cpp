@@ -0,0 +1,227 @@
+/*
+ *  dbc_parser_c.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <memory>
+#include <string>
+#include <optional>
+#include <exception>
+#include "dbc_parser.hpp"
+#include "dbc_parser_c.h"
+
+static_assert(sizeof(DbcSignalValue) == 16, "DbcSignalValue must not have padding");
+static_assert(sizeof(DbcSignalHandle) == sizeof(SignalHandle), "Signal handles must have the same size");
+static_assert(DBC_INVALID_DEFINITION == static_cast<int>(CodecStatus::InvalidDefinition),
+    "DbcStatus must follow CodecStatus");
+
+struct DbcDatabase {
+    DbcParser parser;
+};
+
+namespace {
+
+    thread_local std::string lastError;
+
+    int32_t toStatus(CodecStatus status) {
+        return static_cast<int32_t>(status);
+    }
+
+}
+
+int32_t dbc_open(const char* filePath, int32_t lazy, DbcDatabase** database) {
+    if (filePath == nullptr || database == nullptr) {
+        return DBC_INVALID_ARGUMENT;
+    }
+    *database = nullptr;
+    try {
+        auto opened = std::make_unique<DbcDatabase>();
+        opened->parser.parse(filePath, lazy ? LoadMode::Lazy : LoadMode::Full);
+        *database = opened.release();
+        lastError.clear();
+        return DBC_OK;
+    }
+    catch (const std::exception& e) {
+        lastError = e.what();
+        return DBC_PARSE_ERROR;
+    }
+}
+
+void dbc_close(DbcDatabase* database) {
+    delete database;
+}
+
+const char* dbc_last_error(void) {
+    return lastError.c_str();
+}
+
+const char* dbc_status_string(int32_t status) {
+    if (status == DBC_PARSE_ERROR) {
+        return "Parse error";
+    }
+    if (status == DBC_INVALID_ARGUMENT) {
+        return "Invalid argument";
+    }
+    if (status < DBC_OK || status > DBC_INVALID_DEFINITION) {
+        return "Unknown status";
+    }
+    return toString(static_cast<CodecStatus>(status));
+}
+
+uint32_t dbc_signal_count(const DbcDatabase* database) {
+    return database == nullptr ? 0 : database->parser.getSignalCount();
+}
+
+int32_t dbc_signal_handle(const DbcDatabase* database, uint32_t msgId, const char* signalName,
+    DbcSignalHandle* handle) {
+    if (database == nullptr || signalName == nullptr || handle == nullptr) {
+        return DBC_INVALID_ARGUMENT;
+    }
+    try {
+        std::optional<SignalHandle> found = database->parser.getSignalHandle(msgId, signalName);
+        if (!found.has_value()) {
+            return DBC_UNKNOWN_SIGNAL;
+        }
+        *handle = found.value();
+        return DBC_OK;
+    }
+    catch (const std::exception&) {
+        return DBC_INVALID_DEFINITION;
+    }
+}
+
+const char* dbc_signal_name(const DbcDatabase* database, DbcSignalHandle handle) {
+    if (database == nullptr) {
+        return nullptr;
+    }
+    try {
+        const Signal* sig = database->parser.getSignal(handle);
+        // The name is a std::pmr::string inside the database, so it is null-terminated
+        return sig == nullptr ? nullptr : sig->getNameView().data();
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+const char* dbc_signal_unit(const DbcDatabase* database, DbcSignalHandle handle) {
+    if (database == nullptr) {
+        return nullptr;
+    }
+    try {
+        const Signal* sig = database->parser.getSignal(handle);
+        return sig == nullptr ? nullptr : sig->getUnitView().data();
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+int32_t dbc_signal_message_id(const DbcDatabase* database, DbcSignalHandle handle, uint32_t* msgId) {
+    if (database == nullptr || msgId == nullptr) {
+        return DBC_INVALID_ARGUMENT;
+    }
+    try {
+        const Message* message = database->parser.getMessageOfSignal(handle);
+        if (message == nullptr) {
+            return DBC_UNKNOWN_SIGNAL;
+        }
+        *msgId = static_cast<uint32_t>(message->getId());
+        return DBC_OK;
+    }
+    catch (const std::exception&) {
+        return DBC_INVALID_DEFINITION;
+    }
+}
+
+uint32_t dbc_max_message_length(const DbcDatabase* database) {
+    return database == nullptr ? 0 : database->parser.getMaxMessageLength();
+}
+
+size_t dbc_decode_batch(const DbcDatabase* database, size_t frameCount,
+    const uint32_t* ids, const uint8_t* sizes, const uint8_t* payloads, size_t payloadStride,
+    DbcSignalValue* values, size_t valueCapacity, size_t* framesDone, uint8_t* frameStatus) {
+    size_t valueCount = 0;
+    size_t frameIndex = 0;
+    if (database != nullptr && ids != nullptr && sizes != nullptr && payloads != nullptr
+        && (values != nullptr || valueCapacity == 0)) {
+        for (; frameIndex < frameCount; frameIndex++) {
+            size_t frameBegin = valueCount;
+            CodecStatus status;
+            // Checked before decoding, so a frame left for the next call is not counted in the metrics twice
+            size_t signalCount = database->parser.getDecodedSignalCount(ids[frameIndex], sizes[frameIndex]);
+            if (signalCount > valueCapacity - valueCount) {
+                // Leave the whole frame for the next call, unless it is the first one: then it does
+                // not fit into valueCapacity at all, and is skipped so that retrying moves on
+                if (frameBegin != 0) {
+                    break;
+                }
+                status = CodecStatus::BufferTooSmall;
+            }
+            else {
+                try {
+                    status = database->parser.tryDecodeSignals(ids[frameIndex], sizes[frameIndex],
+                        payloads + frameIndex * payloadStride,
+                        [&](const Signal& sig, double value) {
+                            values[valueCount++] = { static_cast<uint32_t>(frameIndex), sig.getHandle(), value };
+                        });
+                }
+                catch (const std::exception&) {
+                    valueCount = frameBegin;
+                    status = CodecStatus::InvalidDefinition;
+                }
+            }
+            if (frameStatus != nullptr) {
+                frameStatus[frameIndex] = static_cast<uint8_t>(status);
+            }
+        }
+    }
+    if (framesDone != nullptr) {
+        *framesDone = frameIndex;
+    }
+    return valueCount;
+}
+
+int32_t dbc_encode(const DbcDatabase* database, uint32_t msgId,
+    const DbcSignalHandle* handles, const double* values, size_t valueCount,
+    uint8_t* payload, uint32_t payloadCapacity, uint32_t* encodedSize) {
+    if (database == nullptr || payload == nullptr || encodedSize == nullptr
+        || (valueCount != 0 && (handles == nullptr || values == nullptr))) {
+        return DBC_INVALID_ARGUMENT;
+    }
+    unsigned int msgSize = 0;
+    CodecStatus status = database->parser.tryEncode(msgId, handles, values, valueCount,
+        payload, payloadCapacity, msgSize);
+    *encodedSize = msgSize;
+    return toStatus(status);
+}
+
+size_t dbc_encode_batch(const DbcDatabase* database, size_t frameCount, const uint32_t* ids,
+    const DbcSignalHandle* handles, const double* values, const size_t* valueOffsets,
+    uint8_t* payloads, size_t payloadStride, uint32_t* sizes, uint8_t* frameStatus) {
+    if (database == nullptr || ids == nullptr || valueOffsets == nullptr || payloads == nullptr) {
+        return 0;
+    }
+    size_t encodedCount = 0;
+    for (size_t i = 0; i < frameCount; i++) {
+        size_t first = valueOffsets[i];
+        uint32_t msgSize = 0;
+        int32_t status = dbc_encode(database, ids[i],
+            handles == nullptr ? nullptr : handles + first,
+            values == nullptr ? nullptr : values + first,
+            valueOffsets[i + 1] - first,
+            payloads + i * payloadStride, static_cast<uint32_t>(payloadStride), &msgSize);
+        if (status == DBC_OK || status == DBC_VALUE_OUT_OF_RANGE) {
+            encodedCount++;
+        }
+        if (sizes != nullptr) {
+            sizes[i] = msgSize;
+        }
+        if (frameStatus != nullptr) {
+            frameStatus[i] = static_cast<uint8_t>(status);
+        }
+    }
+    return encodedCount;
+}
@@ -0,0 +1,111 @@
+/*
+ *  dbc_parser_c.h
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef DBC_PARSER_C_H
+#define DBC_PARSER_C_H
+
+/*
+ * C interface of DbcParser, for use from other languages through their FFI.
+ * Signals are referred to by handle, values are passed in caller-owned flat arrays.
+ * Apart from dbc_open(), no function allocates memory or copies strings. The exception is a
+ * database opened with lazy set: each message is parsed, and allocates, the first time it is used.
+ * A database may be used from several threads at once, except for dbc_close().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct DbcDatabase DbcDatabase;
+typedef uint32_t DbcSignalHandle;
+
+/* Same values as CodecStatus, plus the errors of the C interface itself */
+typedef enum DbcStatus {
+    DBC_OK = 0,
+    DBC_UNKNOWN_MESSAGE = 1,
+    DBC_UNKNOWN_BUS_TYPE = 2,
+    DBC_DLC_MISMATCH = 3,
+    DBC_UNKNOWN_SIGNAL = 4,
+    DBC_VALUE_OUT_OF_RANGE = 5,
+    DBC_BUFFER_TOO_SMALL = 6,
+    DBC_INVALID_DEFINITION = 7,
+    /* The file could not be opened or parsed, see dbc_last_error() */
+    DBC_PARSE_ERROR = 64,
+    DBC_INVALID_ARGUMENT = 65
+} DbcStatus;
+
+/* One decoded signal of a batch. 16 bytes, no padding */
+typedef struct DbcSignalValue {
+    /* Index of the frame in the batch */
+    uint32_t frameIndex;
+    DbcSignalHandle handle;
+    double value;
+} DbcSignalValue;
+
+/* Parse a DBC file. Set lazy to non-zero to parse each message on first use */
+int32_t dbc_open(const char* filePath, int32_t lazy, DbcDatabase** database);
+void dbc_close(DbcDatabase* database);
+/* Message of the last failed dbc_open() on this thread, "" if there is none */
+const char* dbc_last_error(void);
+/* Human readable text of a status */
+const char* dbc_status_string(int32_t status);
+
+/* Signal handles are dense indices in [0, dbc_signal_count()) */
+uint32_t dbc_signal_count(const DbcDatabase* database);
+/* DBC_UNKNOWN_SIGNAL if there is no such message or signal */
+int32_t dbc_signal_handle(const DbcDatabase* database, uint32_t msgId, const char* signalName,
+    DbcSignalHandle* handle);
+/* Null-terminated names owned by the database, NULL if the handle is out of range */
+const char* dbc_signal_name(const DbcDatabase* database, DbcSignalHandle handle);
+const char* dbc_signal_unit(const DbcDatabase* database, DbcSignalHandle handle);
+int32_t dbc_signal_message_id(const DbcDatabase* database, DbcSignalHandle handle, uint32_t* msgId);
+/* Payload buffer length used by the bus type: 8 for CAN, 64 for CAN FD, 0 if unknown */
+uint32_t dbc_max_message_length(const DbcDatabase* database);
+
+/*
+ * Decode a batch of frames given as columns: ids[i], sizes[i], and the payload of frame i
+ * at payloads + i * payloadStride. Extended IDs have bit 31 set.
+ * Signals are written to values in frame order. Decoding stops before the first frame whose
+ * signals do not fit, *framesDone tells where to continue: call again with the frames from
+ * there on until all are done. A frame with more signals than valueCapacity never fits, so
+ * it is skipped instead, with DBC_BUFFER_TOO_SMALL and no values. Every call that is given
+ * frames therefore finishes at least one of them.
+ * frameStatus may be NULL, otherwise it receives a DbcStatus for every frame that was done.
+ * Returns the number of values written.
+ */
+size_t dbc_decode_batch(const DbcDatabase* database, size_t frameCount,
+    const uint32_t* ids, const uint8_t* sizes, const uint8_t* payloads, size_t payloadStride,
+    DbcSignalValue* values, size_t valueCapacity, size_t* framesDone, uint8_t* frameStatus);
+
+/*
+ * Encode one message with values[i] for signal handles[i].
+ * Signals without a value get their initial value.
+ * *encodedSize receives the message size when the result is DBC_OK or DBC_VALUE_OUT_OF_RANGE.
+ */
+int32_t dbc_encode(const DbcDatabase* database, uint32_t msgId,
+    const DbcSignalHandle* handles, const double* values, size_t valueCount,
+    uint8_t* payload, uint32_t payloadCapacity, uint32_t* encodedSize);
+
+/*
+ * Encode a batch of messages. The signals of frame i are handles[j] with values[j] for
+ * valueOffsets[i] <= j < valueOffsets[i + 1], so valueOffsets has frameCount + 1 entries.
+ * Frame i is written to payloads + i * payloadStride, with payloadStride bytes of room.
+ * sizes and frameStatus may be NULL. Returns the number of frames that got DBC_OK or
+ * DBC_VALUE_OUT_OF_RANGE.
+ */
+size_t dbc_encode_batch(const DbcDatabase* database, size_t frameCount, const uint32_t* ids,
+    const DbcSignalHandle* handles, const double* values, const size_t* valueOffsets,
+    uint8_t* payloads, size_t payloadStride, uint32_t* sizes, uint8_t* frameStatus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DBC_PARSER_C_H */
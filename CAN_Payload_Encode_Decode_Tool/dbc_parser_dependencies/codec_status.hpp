@@ -0,0 +1,44 @@
+//
+//  codec_status.hpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef codec_status_h
+#define codec_status_h
+
+// Result of the non-throwing decode/encode functions
+enum class CodecStatus : unsigned char {
+    Ok,
+    // The message ID is not in the database
+    UnknownMessage,
+    // The database does not define BusType as CAN or CAN FD
+    UnknownBusType,
+    // The payload length does not match the DLC in the database
+    DlcMismatch,
+    // A signal to encode does not belong to the message
+    UnknownSignal,
+    // Encoded, but at least one value was out of range and replaced by its initial value
+    ValueOutOfRange,
+    // The output buffer is smaller than the message
+    BufferTooSmall,
+    // The definition of a lazily loaded message could not be parsed
+    InvalidDefinition
+};
+
+inline const char* toString(CodecStatus status) {
+    switch (status) {
+    case CodecStatus::Ok: return "Ok";
+    case CodecStatus::UnknownMessage: return "Unknown message";
+    case CodecStatus::UnknownBusType: return "Unknown bus type";
+    case CodecStatus::DlcMismatch: return "DLC mismatch";
+    case CodecStatus::UnknownSignal: return "Unknown signal";
+    case CodecStatus::ValueOutOfRange: return "Value out of range";
+    case CodecStatus::BufferTooSmall: return "Buffer too small";
+    case CodecStatus::InvalidDefinition: return "Invalid message definition";
+    }
+    return "Unknown status";
+}
+
+#endif /* codec_status_h */
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 // Template of variables that can be set only once
 template <typename T, typename Counter = unsigned char>
@@ -52,6 +53,16 @@ namespace utils {
         trim(word);
         return word;
     }
+    // Hash and equality for string keyed maps, so they can be searched with
+    // any kind of string without building a key string first
+    struct StringViewHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+    struct StringViewEqual {
+        using is_transparent = void;
+        bool operator()(std::string_view lhs, std::string_view rhs) const { return lhs == rhs; }
+    };
     // A custom stoi function that detects the input number base
     inline int stoi(std::string number) {
         if (number[0] == '0' && number.size() > 1) {
@@ -0,0 +1,63 @@
+//
+//  j1939.hpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef j1939_h
+#define j1939_h
+
+#include <cstdint>
+
+// Destination address of broadcast (PDU2) messages
+constexpr unsigned char J1939_GLOBAL_ADDRESS = 0xFF;
+// PDU format values below this are PDU1 (destination specific), the others PDU2 (broadcast)
+constexpr unsigned int J1939_PDU2_FORMAT_MIN = 240;
+
+// Fields of a 29-bit J1939 identifier:
+// priority (3 bits) | extended data page, data page (2 bits) | PDU format (8 bits) | PDU specific (8 bits) | source address (8 bits)
+struct J1939Id {
+    // Parameter group number. For PDU1 messages the PDU specific byte is not part of it
+    uint32_t pgn{};
+    unsigned char priority{};
+    unsigned char sourceAddress{};
+    // Taken from the PDU specific byte for PDU1 messages, J1939_GLOBAL_ADDRESS for PDU2 messages
+    unsigned char destinationAddress{ J1939_GLOBAL_ADDRESS };
+    bool isPdu1() const { return ((pgn >> 8) & 0xFF) < J1939_PDU2_FORMAT_MIN; }
+};
+
+// Bits above the 29-bit identifier, such as the extended frame flag, are ignored
+inline J1939Id decomposeJ1939Id(unsigned long canId) {
+    J1939Id result;
+    uint32_t dataPage = static_cast<uint32_t>(canId >> 24) & 0x3;
+    uint32_t pduFormat = static_cast<uint32_t>(canId >> 16) & 0xFF;
+    uint32_t pduSpecific = static_cast<uint32_t>(canId >> 8) & 0xFF;
+    result.priority = static_cast<unsigned char>((canId >> 26) & 0x7);
+    result.sourceAddress = static_cast<unsigned char>(canId & 0xFF);
+    if (pduFormat < J1939_PDU2_FORMAT_MIN) {
+        result.pgn = (dataPage << 16) | (pduFormat << 8);
+        result.destinationAddress = static_cast<unsigned char>(pduSpecific);
+    }
+    else {
+        result.pgn = (dataPage << 16) | (pduFormat << 8) | pduSpecific;
+        result.destinationAddress = J1939_GLOBAL_ADDRESS;
+    }
+    return result;
+}
+
+// 29-bit identifier without the extended frame flag
+inline unsigned long composeJ1939Id(const J1939Id& j1939Id) {
+    unsigned long canId = (static_cast<unsigned long>(j1939Id.priority & 0x7) << 26)
+        | (static_cast<unsigned long>(j1939Id.pgn & 0x3FF00) << 8)
+        | j1939Id.sourceAddress;
+    if (j1939Id.isPdu1()) {
+        canId |= static_cast<unsigned long>(j1939Id.destinationAddress) << 8;
+    }
+    else {
+        canId |= static_cast<unsigned long>(j1939Id.pgn & 0xFF) << 8;
+    }
+    return canId;
+}
+
+#endif /* j1939_h */
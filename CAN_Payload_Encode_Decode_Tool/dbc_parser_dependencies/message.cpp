@@ -8,8 +8,29 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include "message.hpp"
 
+Message::Message(const allocator_type& allocator) :
+    name(allocator), senderName(allocator), signalsLibrary(allocator) {}
+
+// Assigning keeps the allocator of this message, so the contents end up in its memory resource
+Message::Message(const Message& other, const allocator_type& allocator) : Message(allocator) {
+    *this = other;
+}
+
+Message::Message(Message&& other, const allocator_type& allocator) : Message(allocator) {
+    *this = std::move(other);
+}
+
+std::unordered_map<std::string, Signal> Message::getSignalsInfo() const {
+    std::unordered_map<std::string, Signal> signalsInfo;
+    for (auto& it : signalsLibrary) {
+        signalsInfo.emplace(std::string(it.first), it.second);
+    }
+    return signalsInfo;
+}
+
 std::istream& Message::parseSigInitialValue(std::istream& in) {
     // Read signal name
     std::string sigName;
@@ -61,21 +82,66 @@ std::istream& Message::parseAdditionalSigValueType(std::istream& in) {
     return in;
 }
 
+SignalHandle Message::assignSignalHandles(SignalHandle const firstHandle) {
+    for (auto& it : signalsLibrary) {
+        it.second.setHandle(firstHandle + it.second.getPosition());
+    }
+    return firstHandle + static_cast<SignalHandle>(signalsLibrary.size());
+}
+
+void Message::analyzeLayout(std::vector<LayoutIssue>& issues) {
+    occupancy.fill(0);
+    std::vector<const Signal*> signals;
+    signals.reserve(signalsLibrary.size());
+    for (auto const& it : signalsLibrary) {
+        signals.push_back(&it.second);
+    }
+    std::sort(signals.begin(), signals.end(), [](const Signal* lhs, const Signal* rhs) {
+        return lhs->getPosition() < rhs->getPosition();
+    });
+    for (size_t i = 0; i < signals.size(); i++) {
+        const Signal& sig = *signals[i];
+        if (sig.getFirstByte() + sig.getByteCount() > messageSize) {
+            issues.push_back({ LayoutIssueType::OutOfBounds, id, sig.getName(), "" });
+        }
+        bool isOverlapping = false;
+        for (unsigned int b = 0; b < sig.getByteCount(); b++) {
+            unsigned int byteIndex = sig.getFirstByte() + b;
+            if (byteIndex < MAX_LAYOUT_BYTES) {
+                isOverlapping |= (occupancy[byteIndex] & sig.getByteMask(b)) != 0;
+                occupancy[byteIndex] |= sig.getByteMask(b);
+            }
+        }
+        if (!isOverlapping) {
+            continue;
+        }
+        // Only broken layouts get here, so find the culprits by comparing with every earlier signal
+        for (size_t j = 0; j < i; j++) {
+            const Signal& other = *signals[j];
+            bool isShared = false;
+            for (unsigned int b = 0; b < sig.getByteCount() && !isShared; b++) {
+                unsigned int byteIndex = sig.getFirstByte() + b;
+                if (byteIndex >= other.getFirstByte()) {
+                    isShared = sig.getByteMask(b) & other.getByteMask(byteIndex - other.getFirstByte());
+                }
+            }
+            if (isShared) {
+                issues.push_back({ LayoutIssueType::Overlap, id, sig.getName(), other.getName() });
+            }
+        }
+    }
+}
+
 std::unordered_map<std::string, double> Message::decode(
     unsigned char const rawPayload[],
     unsigned short const MAX_MSG_LEN,
     unsigned int const msgSize) {
-    // Check input payload length
-    if (msgSize != messageSize) {
-        throw std::invalid_argument("Decode failed. "
-            "The data length of the input payload does not match with DBC info.");
-    }
     // Decode
     std::unordered_map<std::string, double> sigValues;
-    for (auto& it : signalsLibrary) {
-        sigValues.insert(std::make_pair(it.second.getName(),
-            it.second.decodeSignal(rawPayload, MAX_MSG_LEN, messageSize)));
-    }
+    decodeSignals(rawPayload, MAX_MSG_LEN, msgSize,
+        [&sigValues](const Signal& sig, double value) {
+            sigValues.insert(std::make_pair(sig.getName(), value));
+        });
     return sigValues;
 }
 
@@ -83,7 +149,8 @@ unsigned int Message::encode(
     std::vector<std::pair<std::string, double> >& signalsToEncode,
     unsigned char encodedPayload[],
     unsigned short const MAX_MSG_LEN,
-    const double defaultGlobalInitialValue) {
+    const double defaultGlobalInitialValue,
+    unsigned int* outOfRangeCount) {
     for (size_t i = 0; i < MAX_MSG_LEN; i++) {
         encodedPayload[i] = 0;
     }
@@ -95,10 +162,11 @@ unsigned int Message::encode(
                 + signalsToEncode[i].first
                 + " in CAN database.");
         }
-        double rawValue = (signalsToEncode[i].second - signals_itr->second.getOffset()) / signals_itr->second.getFactor();
         // Check if the provided value is within its min and max range
-        if (!(rawValue <= signals_itr->second.getMaxValue()
-            && rawValue >= signals_itr->second.getMinValue())) {
+        if (!signals_itr->second.isInRange(signalsToEncode[i].second)) {
+            if (outOfRangeCount != nullptr) {
+                (*outOfRangeCount)++;
+            }
             std::cerr << "<Warning> Trying to encode a value that is out of the min and max range of signal "
                 << std::quoted(name) << " is not allowed. This signal will encode with its initial value: "
                 << signals_itr->second.getInitialValue().value_or(defaultGlobalInitialValue)
@@ -112,20 +180,16 @@ unsigned int Message::encode(
         }
     }
     // Find the signal, then encode
+    // Each signal only replaces its own bits, so all of them go straight into the payload
     for (auto& sig : signalsLibrary) {
         bool hasValuetoEncode = false;
-        unsigned char* encodedPayloadOfSingleSig = new unsigned char[MAX_MSG_LEN];
-        // Explicitly clear and set to 0 (recessive bit) to the array before encode
-        for (size_t i = 0; i < MAX_MSG_LEN; i++) {
-            encodedPayloadOfSingleSig[i] = 0;
-        }
         // If value is provided, encode it
         for (unsigned short i = 0; i < signalsToEncode.size(); i++) {
-            if (signalsToEncode[i].first == sig.first) {
+            if (signalsToEncode[i].first == std::string_view(sig.first)) {
                 hasValuetoEncode = true;
                 // Encode the requested value
                 sig.second.encodeSignal(signalsToEncode[i].second,
-                    encodedPayloadOfSingleSig,
+                    encodedPayload,
                     MAX_MSG_LEN);
                 break;
             }
@@ -138,18 +202,32 @@ unsigned int Message::encode(
                 + sig.second.getOffset();
             // Encode with initial value
             sig.second.encodeSignal(initialPhysicalValue,
-                encodedPayloadOfSingleSig,
+                encodedPayload,
                 MAX_MSG_LEN);
         }
-        // Merge single result with results from other signals
-        for (size_t i = 0; i < MAX_MSG_LEN; i++) {
-            encodedPayload[i] |= encodedPayloadOfSingleSig[i];
-        }
-        delete[] encodedPayloadOfSingleSig;
     }
     return messageSize;
 }
 
+CodecStatus Message::tryEncode(
+    std::pair<std::string, double> const signalsToEncode[],
+    size_t const signalCount,
+    unsigned char encodedPayload[],
+    unsigned int const encodedPayloadSize,
+    double const defaultGlobalInitialValue,
+    unsigned int& outOfRangeCount) const {
+    return tryEncodeSignals(signalCount,
+        [this, signalsToEncode](size_t i) {
+            auto signals_itr = signalsLibrary.find(signalsToEncode[i].first);
+            const Signal* sig = signals_itr == signalsLibrary.end() ? nullptr : &signals_itr->second;
+            return std::pair<const Signal*, double>(sig, signalsToEncode[i].second);
+        },
+        encodedPayload,
+        encodedPayloadSize,
+        defaultGlobalInitialValue,
+        outOfRangeCount);
+}
+
 std::istream& operator>>(std::istream& in, Message& msg) {
     // Read message ID
     in >> msg.id;
@@ -168,15 +246,13 @@ std::istream& operator>>(std::istream& in, Message& msg) {
     std::string preamble;
     while (in >> preamble && preamble == "SG_") {
         // Read signal info
-        Signal sig;
+        Signal sig(msg.signalsLibrary.get_allocator());
         in >> sig;
+        sig.setPosition(static_cast<unsigned int>(msg.signalsLibrary.size()));
         // Signal name uniqueness check. Signal names by definition need to be unqiue within each message
-        Message::signalsLibrary_iterator data_itr = msg.signalsLibrary.find(sig.getName());
-        if (data_itr == msg.signalsLibrary.end()) {
-            // Uniqueness check passed, store the signal
-            msg.signalsLibrary.insert(std::make_pair(sig.getName(), sig));
-        }
-        else {
+        // The signal is moved into the library, nothing is copied
+        std::pmr::string sigName(sig.getNameView(), msg.signalsLibrary.get_allocator());
+        if (!msg.signalsLibrary.try_emplace(std::move(sigName), std::move(sig)).second) {
             // Uniqueness check failed, then something must be wrong with the DBC file, parse failed
             throw std::invalid_argument("Parse Failed. Signal \"" + sig.getName()
                 + "\" has duplicates in the same message.");
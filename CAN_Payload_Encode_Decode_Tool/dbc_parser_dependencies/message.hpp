@@ -9,27 +9,110 @@
 #define MESSAGE_H
 
 #include <set>
+#include <array>
 #include <string>
 #include <vector>
 #include <iosfwd>
 #include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
+#include <memory_resource>
 #include "signal.hpp"
+#include "codec_status.hpp"
+
+// Payload bytes covered by the occupancy bitmap of a message, the size of a CAN FD frame
+constexpr unsigned int MAX_LAYOUT_BYTES = 64;
+
+enum class LayoutIssueType {
+    // Two signals share at least one bit
+    Overlap,
+    // The signal reaches past the DLC of its message
+    OutOfBounds
+};
+
+struct LayoutIssue {
+    LayoutIssueType type = LayoutIssueType::Overlap;
+    unsigned long msgId{};
+    std::string signalName;
+    // The signal it overlaps with, empty for OutOfBounds
+    std::string otherSignalName;
+};
 
 class Message {
 
 public:
 
+    // Name, signals and everything inside them are allocated from one memory resource,
+    // normally the arena of the DbcParser that owns the message
+    typedef std::pmr::polymorphic_allocator<char> allocator_type;
+    // <Signal name, Signal object>, can be searched with any string type
+    typedef std::pmr::unordered_map<std::pmr::string, Signal, utils::StringViewHash, utils::StringViewEqual> SignalLibrary;
+    Message() = default;
+    explicit Message(const allocator_type& allocator);
+    Message(const Message& other, const allocator_type& allocator);
+    Message(Message&& other, const allocator_type& allocator);
+    Message(const Message&) = default;
+    Message(Message&&) = default;
+    Message& operator=(const Message&) = default;
+    Message& operator=(Message&&) = default;
     // Getter functions for all the possible data one can request from a Message
     unsigned long getId() const { return id; }
+    // Position of the message in the DBC file
+    unsigned int getIndex() const { return index; }
+    void setIndex(const unsigned int index) { this->index = index; }
     unsigned int getDlc() const { return messageSize; }
-    std::string getName() const { return name; }
-    std::string getSenderNames() const { return senderName; }
-    std::unordered_map<std::string, Signal> getSignalsInfo() const { return signalsLibrary; }
+    std::string getName() const { return std::string(name); }
+    std::string getSenderNames() const { return std::string(senderName); }
+    // Send period in ms from BA_ "GenMsgCycleTime", empty if the database does not give one
+    std::optional<unsigned int> getCycleTime() const { return cycleTime; }
+    // Faster send period from BA_ "GenMsgCycleTimeFast", used while the message is active
+    std::optional<unsigned int> getFastCycleTime() const { return fastCycleTime; }
+    void setCycleTime(const unsigned int cycleTime) { this->cycleTime = cycleTime; }
+    void setFastCycleTime(const unsigned int fastCycleTime) { this->fastCycleTime = fastCycleTime; }
+    std::unordered_map<std::string, Signal> getSignalsInfo() const;
+    // Same as getSignalsInfo() but without copying the signals
+    const SignalLibrary& getSignals() const { return signalsLibrary; }
     // Parse signal value descrption
     std::istream& parseSigInitialValue(std::istream& in);
     std::istream& parseSigValueDescription(std::istream& in);
     std::istream& parseAdditionalSigValueType(std::istream& in);
+    // Take over the signals of another message. Used to fill in a lazily loaded message
+    // without touching its other fields, which other threads may be reading
+    void moveSignalsFrom(Message&& other) {
+        signalsLibrary = std::move(other.signalsLibrary);
+        occupancy = other.occupancy;
+    }
+    // Give every signal its global handle, starting from firstHandle in DBC file order
+    // Returns the next handle that is still free
+    SignalHandle assignSignalHandles(SignalHandle const firstHandle);
+    // Fill the occupancy bitmap from the signal layouts and append overlapping
+    // and out of bounds signals to issues, in signal position order
+    void analyzeLayout(std::vector<LayoutIssue>& issues);
+    // Bit i of byte b is set if a signal uses bit i of payload byte b
+    const std::array<uint8_t, MAX_LAYOUT_BYTES>& getOccupancy() const { return occupancy; }
+    // Calls visitor(const Signal&) for every signal whose bits differ between the two payloads
+    // Frames that only differ in unused bits are rejected without looking at any signal
+    template <typename SignalVisitor>
+    void forEachChangedSignal(
+        unsigned char const previousPayload[],
+        unsigned char const currentPayload[],
+        SignalVisitor&& visitor
+    ) const {
+        bool isChanged = false;
+        unsigned int usedBytes = messageSize < MAX_LAYOUT_BYTES ? messageSize : MAX_LAYOUT_BYTES;
+        for (unsigned int i = 0; i < usedBytes && !isChanged; i++) {
+            isChanged = (previousPayload[i] ^ currentPayload[i]) & occupancy[i];
+        }
+        if (!isChanged) {
+            return;
+        }
+        for (auto const& it : signalsLibrary) {
+            if (it.second.isChanged(previousPayload, currentPayload)) {
+                visitor(it.second);
+            }
+        }
+    }
     // Used to encode/decode messages
     std::unordered_map<std::string, double> decode(
         unsigned char const rawPayload[],
@@ -40,24 +123,145 @@ public:
         std::vector<std::pair<std::string, double> >& signalsToEncode,
         unsigned char encodedPayload[],
         unsigned short const MAX_MSG_LEN,
-        double const defaultGlobalInitialValue
+        double const defaultGlobalInitialValue,
+        unsigned int* outOfRangeCount = nullptr
     );
+    // Decode kernel shared by all decoders. Each decoded signal is passed to the visitor
+    // as (const Signal&, double physicalValue), no result map is built
+    // Returns CodecStatus::DlcMismatch without calling the visitor if msgSize does not match
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeSignals(
+        unsigned char const rawPayload[],
+        unsigned short const MAX_MSG_LEN,
+        unsigned int const msgSize,
+        SignalVisitor&& visitor
+    ) const {
+        // Check input payload length
+        if (msgSize != messageSize) {
+            return CodecStatus::DlcMismatch;
+        }
+        for (auto const& it : signalsLibrary) {
+            visitor(it.second, it.second.decodeSignal(rawPayload, MAX_MSG_LEN, messageSize));
+        }
+        return CodecStatus::Ok;
+    }
+    // Same as tryDecodeSignals but throws on a DLC mismatch
+    template <typename SignalVisitor>
+    void decodeSignals(
+        unsigned char const rawPayload[],
+        unsigned short const MAX_MSG_LEN,
+        unsigned int const msgSize,
+        SignalVisitor&& visitor
+    ) const {
+        if (tryDecodeSignals(rawPayload, MAX_MSG_LEN, msgSize, std::forward<SignalVisitor>(visitor))
+            == CodecStatus::DlcMismatch) {
+            throw std::invalid_argument("Decode failed. "
+                "The data length of the input payload does not match with DBC info.");
+        }
+    }
+    // Encode without exceptions, console output or heap allocation
+    // Out of range values are replaced by their initial value and counted in outOfRangeCount
+    CodecStatus tryEncode(
+        std::pair<std::string, double> const signalsToEncode[],
+        size_t const signalCount,
+        unsigned char encodedPayload[],
+        unsigned int const encodedPayloadSize,
+        double const defaultGlobalInitialValue,
+        unsigned int& outOfRangeCount
+    ) const;
+    // Encode kernel shared by all encoders. signalValueAt(i) returns the i-th
+    // std::pair<const Signal*, double> to encode, the signal must belong to this message
+    // or be nullptr, which fails with CodecStatus::UnknownSignal
+    template <typename SignalValueAt>
+    CodecStatus tryEncodeSignals(
+        size_t const signalCount,
+        SignalValueAt&& signalValueAt,
+        unsigned char encodedPayload[],
+        unsigned int const encodedPayloadSize,
+        double const defaultGlobalInitialValue,
+        unsigned int& outOfRangeCount
+    ) const {
+        if (encodedPayloadSize < messageSize) {
+            return CodecStatus::BufferTooSmall;
+        }
+        for (size_t i = 0; i < encodedPayloadSize; i++) {
+            encodedPayload[i] = 0;
+        }
+        // Remember which signals got a value, by signal position. A CAN FD message holds at most
+        // 512 bits, so signals past that position can only exist in broken databases and
+        // are looked up through signalValueAt instead
+        constexpr unsigned int MAX_TRACKED_SIGNALS = 64 * CHAR_BIT;
+        uint64_t hasValueToEncode[MAX_TRACKED_SIGNALS / 64] = {};
+        outOfRangeCount = 0;
+        for (size_t i = 0; i < signalCount; i++) {
+            std::pair<const Signal*, double> signalValue = signalValueAt(i);
+            if (signalValue.first == nullptr) {
+                for (size_t j = 0; j < encodedPayloadSize; j++) {
+                    encodedPayload[j] = 0;
+                }
+                return CodecStatus::UnknownSignal;
+            }
+            const Signal& sig = *signalValue.first;
+            unsigned int position = sig.getPosition();
+            if (position < MAX_TRACKED_SIGNALS) {
+                // The first value given for a signal wins, as in encode()
+                if (hasValueToEncode[position / 64] & (1ULL << (position % 64))) {
+                    continue;
+                }
+                hasValueToEncode[position / 64] |= (1ULL << (position % 64));
+            }
+            double physicalValue = signalValue.second;
+            if (!sig.isInRange(physicalValue)) {
+                outOfRangeCount++;
+                physicalValue = sig.getInitialValue().value_or(defaultGlobalInitialValue)
+                    * sig.getFactor()
+                    + sig.getOffset();
+            }
+            sig.encodeSignal(physicalValue, encodedPayload, static_cast<unsigned short>(encodedPayloadSize));
+        }
+        // Signals without a value are encoded with their initial value
+        for (auto& it : signalsLibrary) {
+            const Signal& sig = it.second;
+            unsigned int position = sig.getPosition();
+            bool hasValue = false;
+            if (position < MAX_TRACKED_SIGNALS) {
+                hasValue = hasValueToEncode[position / 64] & (1ULL << (position % 64));
+            }
+            else {
+                for (size_t i = 0; i < signalCount && !hasValue; i++) {
+                    hasValue = signalValueAt(i).first == &sig;
+                }
+            }
+            if (!hasValue) {
+                double initialPhysicalValue = sig.getInitialValue().value_or(defaultGlobalInitialValue)
+                    * sig.getFactor()
+                    + sig.getOffset();
+                sig.encodeSignal(initialPhysicalValue, encodedPayload, static_cast<unsigned short>(encodedPayloadSize));
+            }
+        }
+        return outOfRangeCount ? CodecStatus::ValueOutOfRange : CodecStatus::Ok;
+    }
     // Overload of operator>> to enable parsing of Messages from streams of DBC-Files
     friend std::istream& operator>>(std::istream& in, Message& msg);
 
 private:
 
-    typedef std::unordered_map<std::string, Signal>::iterator signalsLibrary_iterator;
+    typedef SignalLibrary::iterator signalsLibrary_iterator;
     // Name of the Message
-    std::string name{};
+    std::pmr::string name{};
     // The CAN-ID assigned to this specific Message
     unsigned long id{};
+    unsigned int index{};
     // The length of this message in Bytes. Allowed values are between 0 and 8
     unsigned int messageSize{};
+    std::optional<unsigned int> cycleTime{};
+    std::optional<unsigned int> fastCycleTime{};
     // String containing the name of the Sender of this Message if one exists in the DB
-    std::string senderName{};
+    std::pmr::string senderName{};
     // A hash table containing all Signals that are present in this Message <Signal name, Signal object>
-    std::unordered_map<std::string, Signal> signalsLibrary{};
+    SignalLibrary signalsLibrary{};
+    // Used bits of the payload, see analyzeLayout()
+    std::array<uint8_t, MAX_LAYOUT_BYTES> occupancy{};
 
 };
 #endif
@@ -0,0 +1,120 @@
+//
+//  output_buffer.cpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <cerrno>
+#include <charconv>
+#include <ostream>
+#include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#include "output_buffer.hpp"
+
+OutputBuffer::OutputBuffer(std::ostream& out, size_t capacity) :
+    stream(&out), buffer(std::max<size_t>(capacity, MAX_NUMBER_LENGTH)) {}
+
+#if defined(__unix__) || defined(__APPLE__)
+OutputBuffer::OutputBuffer(int fileDescriptor, size_t capacity) :
+    fileDescriptor(fileDescriptor), buffer(std::max<size_t>(capacity, MAX_NUMBER_LENGTH)) {}
+#endif
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+void OutputBuffer::appendNumber(double value) {
+    // Most decoded values are whole numbers, which format much faster as integers
+    if (value > -1e15 && value < 1e15 && value == static_cast<double>(static_cast<int64_t>(value))) {
+        appendNumber(static_cast<int64_t>(value));
+        return;
+    }
+    char* begin = reserve(MAX_NUMBER_LENGTH);
+    used += static_cast<size_t>(std::to_chars(begin, begin + MAX_NUMBER_LENGTH, value).ptr - begin);
+}
+
+void OutputBuffer::appendHex(uint64_t value, unsigned int minDigits) {
+    static constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+    unsigned int digits = 1;
+    while (digits < 16 && (value >> (digits * 4)) != 0) {
+        digits++;
+    }
+    digits = std::clamp(minDigits, digits, 16u);
+    char* out = reserve(digits);
+    for (unsigned int i = 0; i < digits; i++) {
+        out[i] = HEX_DIGITS[(value >> ((digits - i - 1) * 4)) & 0xF];
+    }
+    used += digits;
+}
+
+void OutputBuffer::appendTimestamp(uint64_t microseconds) {
+    appendNumber(microseconds / 1000000);
+    char* out = reserve(7);
+    out[0] = '.';
+    uint64_t fraction = microseconds % 1000000;
+    for (unsigned int i = 6; i > 0; i--) {
+        out[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    used += 7;
+}
+
+void OutputBuffer::appendJsonString(std::string_view text) {
+    static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+    append('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            append('\\');
+            append(c);
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            append("\\u00");
+            append(HEX_DIGITS[(c >> 4) & 0xF]);
+            append(HEX_DIGITS[c & 0xF]);
+        }
+        else {
+            append(c);
+        }
+    }
+    append('"');
+}
+
+void OutputBuffer::flush() {
+    drain();
+    if (stream != nullptr) {
+        stream->flush();
+    }
+}
+
+void OutputBuffer::drain() {
+    if (used != 0) {
+        writeOut(buffer.data(), used);
+        used = 0;
+    }
+}
+
+void OutputBuffer::writeOut(const char* data, size_t size) {
+    if (stream != nullptr) {
+        if (!stream->write(data, static_cast<std::streamsize>(size))) {
+            isFailed = true;
+        }
+        return;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    while (size != 0) {
+        ssize_t written = ::write(fileDescriptor, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            isFailed = true;
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+#endif
+}
@@ -0,0 +1,95 @@
+//
+//  output_buffer.hpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef output_buffer_h
+#define output_buffer_h
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+// Longest output of std::to_chars for a double in shortest form, or for a 64 bit integer
+constexpr size_t MAX_NUMBER_LENGTH = 32;
+
+// Collects formatted text in one large buffer and hands it to a stream or a file descriptor
+// in big blocks. Numbers are formatted with std::to_chars, without locales or stream state.
+// The buffer is flushed when it is full, by flush() and on destruction
+class OutputBuffer {
+
+public:
+
+    explicit OutputBuffer(std::ostream& out, size_t capacity = OUTPUT_BUFFER_SIZE);
+#if defined(__unix__) || defined(__APPLE__)
+    // Writes with write(2). The file descriptor stays open. Only on POSIX systems
+    explicit OutputBuffer(int fileDescriptor, size_t capacity = OUTPUT_BUFFER_SIZE);
+#endif
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    void append(char c) {
+        if (used == buffer.size()) {
+            drain();
+        }
+        buffer[used++] = c;
+    }
+    void append(std::string_view text) {
+        if (used + text.size() > buffer.size()) {
+            drain();
+            if (text.size() > buffer.size()) {
+                writeOut(text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, text.data(), text.size());
+        used += text.size();
+    }
+    // Shortest text that reads back as the same double
+    void appendNumber(double value);
+    template <typename Integer, std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+    void appendNumber(Integer value) {
+        char* begin = reserve(MAX_NUMBER_LENGTH);
+        used += static_cast<size_t>(std::to_chars(begin, begin + MAX_NUMBER_LENGTH, value).ptr - begin);
+    }
+    // Upper case, padded with zeros to at least minDigits
+    void appendHex(uint64_t value, unsigned int minDigits = 1);
+    // Microseconds as seconds with six decimals, e.g. 1436509052.249713
+    void appendTimestamp(uint64_t microseconds);
+    // Quoted and escaped as a JSON string
+    void appendJsonString(std::string_view text);
+    // Write out everything and flush the stream
+    void flush();
+    // True once a write to the file descriptor or stream failed
+    bool hasFailed() const { return isFailed; }
+
+private:
+
+    std::ostream* stream = nullptr;
+#if defined(__unix__) || defined(__APPLE__)
+    int fileDescriptor = -1;
+#endif
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool isFailed = false;
+    // Room for the longest number, flushing first if needed
+    char* reserve(size_t size) {
+        if (used + size > buffer.size()) {
+            drain();
+        }
+        return buffer.data() + used;
+    }
+    // Write out the buffer without flushing the stream
+    void drain();
+    void writeOut(const char* data, size_t size);
+
+};
+
+#endif /* output_buffer_h */
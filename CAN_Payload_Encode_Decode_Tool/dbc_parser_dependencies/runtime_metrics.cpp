@@ -0,0 +1,169 @@
+//
+//  runtime_metrics.cpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <bit>
+#include <sstream>
+#include "runtime_metrics.hpp"
+
+namespace {
+
+    const char* const OPERATION_NAMES[3] = { "parse", "decode", "encode" };
+
+    void writeHistogramText(std::ostream& os, const char* name, const LatencyHistogram& histogram) {
+        os << name << " latency: count " << histogram.count;
+        if (histogram.count) {
+            os << ", mean " << histogram.meanNanoseconds() << " ns"
+                << ", p50 <" << histogram.quantileNanoseconds(0.5) << " ns"
+                << ", p99 <" << histogram.quantileNanoseconds(0.99) << " ns";
+        }
+        os << '\n';
+    }
+
+    void writeHistogramJson(std::ostream& os, const char* name, const LatencyHistogram& histogram) {
+        os << '"' << name << "\":{\"count\":" << histogram.count
+            << ",\"totalNs\":" << histogram.totalNanoseconds
+            << ",\"buckets\":[";
+        for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+            os << (i ? "," : "") << histogram.buckets[i];
+        }
+        os << "]}";
+    }
+
+}
+
+uint64_t LatencyHistogram::quantileNanoseconds(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(quantile * count);
+    uint64_t cumulative = 0;
+    for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+        cumulative += buckets[i];
+        if (cumulative > target) {
+            return 1ULL << i;
+        }
+    }
+    return 1ULL << (LATENCY_BUCKET_COUNT - 1);
+}
+
+std::string MetricsSnapshot::toText() const {
+    std::ostringstream os;
+    os << "Frames decoded: " << framesDecoded << '\n'
+        << "Frames encoded: " << framesEncoded << '\n'
+        << "Unknown IDs: " << unknownIds << '\n'
+        << "DLC mismatches: " << dlcMismatches << '\n'
+        << "Out of range encodes: " << outOfRangeEncodes << '\n'
+        << "Unknown signals: " << unknownSignals << '\n';
+    for (auto& perId : framesDecodedPerId) {
+        os << "  ID " << perId.first << ": " << perId.second << " frames decoded\n";
+    }
+    writeHistogramText(os, "Parse", parseLatency);
+    writeHistogramText(os, "Decode", decodeLatency);
+    writeHistogramText(os, "Encode", encodeLatency);
+    return os.str();
+}
+
+std::string MetricsSnapshot::toJson() const {
+    std::ostringstream os;
+    os << "{\"framesDecoded\":" << framesDecoded
+        << ",\"framesEncoded\":" << framesEncoded
+        << ",\"unknownIds\":" << unknownIds
+        << ",\"dlcMismatches\":" << dlcMismatches
+        << ",\"outOfRangeEncodes\":" << outOfRangeEncodes
+        << ",\"unknownSignals\":" << unknownSignals
+        << ",\"framesDecodedPerId\":{";
+    bool isFirst = true;
+    for (auto& perId : framesDecodedPerId) {
+        os << (isFirst ? "" : ",") << '"' << perId.first << "\":" << perId.second;
+        isFirst = false;
+    }
+    os << "},\"latency\":{";
+    writeHistogramJson(os, OPERATION_NAMES[0], parseLatency);
+    os << ',';
+    writeHistogramJson(os, OPERATION_NAMES[1], decodeLatency);
+    os << ',';
+    writeHistogramJson(os, OPERATION_NAMES[2], encodeLatency);
+    os << "}}";
+    return os.str();
+}
+
+unsigned int RuntimeMetrics::threadSlotIndex() {
+    // Threads take slots round robin the first time they count something
+    static std::atomic<unsigned int> nextSlot{ 0 };
+    thread_local unsigned int slotIndex = nextSlot.fetch_add(1, std::memory_order_relaxed) % METRICS_SLOT_COUNT;
+    return slotIndex;
+}
+
+void RuntimeMetrics::setMessageIds(const std::vector<unsigned long>& ids) {
+    messageIds = ids;
+    for (auto& slot : slots) {
+        slot.framesDecodedPerMessage.reset(new std::atomic<uint64_t>[ids.size()]());
+    }
+}
+
+void RuntimeMetrics::recordLatency(MetricsOperation operation, uint64_t nanoseconds) {
+    unsigned int op = static_cast<unsigned int>(operation);
+    unsigned int bucket = static_cast<unsigned int>(std::bit_width(nanoseconds));
+    if (bucket >= LATENCY_BUCKET_COUNT) {
+        bucket = LATENCY_BUCKET_COUNT - 1;
+    }
+    Slot& slot = localSlot();
+    slot.latencyBuckets[op][bucket].fetch_add(1, std::memory_order_relaxed);
+    slot.latencyCount[op].fetch_add(1, std::memory_order_relaxed);
+    slot.latencyTotal[op].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+MetricsSnapshot RuntimeMetrics::snapshot() const {
+    MetricsSnapshot result;
+    std::vector<uint64_t> perMessage(messageIds.size(), 0);
+    LatencyHistogram* histograms[3] = { &result.parseLatency, &result.decodeLatency, &result.encodeLatency };
+    for (auto& slot : slots) {
+        result.framesDecoded += slot.framesDecoded.load(std::memory_order_relaxed);
+        result.framesEncoded += slot.framesEncoded.load(std::memory_order_relaxed);
+        result.unknownIds += slot.unknownIds.load(std::memory_order_relaxed);
+        result.dlcMismatches += slot.dlcMismatches.load(std::memory_order_relaxed);
+        result.outOfRangeEncodes += slot.outOfRangeEncodes.load(std::memory_order_relaxed);
+        result.unknownSignals += slot.unknownSignals.load(std::memory_order_relaxed);
+        for (unsigned int op = 0; op < 3; op++) {
+            for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+                histograms[op]->buckets[i] += slot.latencyBuckets[op][i].load(std::memory_order_relaxed);
+            }
+            histograms[op]->count += slot.latencyCount[op].load(std::memory_order_relaxed);
+            histograms[op]->totalNanoseconds += slot.latencyTotal[op].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < messageIds.size(); i++) {
+            perMessage[i] += slot.framesDecodedPerMessage[i].load(std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < messageIds.size(); i++) {
+        if (perMessage[i]) {
+            result.framesDecodedPerId[messageIds[i]] = perMessage[i];
+        }
+    }
+    return result;
+}
+
+void RuntimeMetrics::reset() {
+    for (auto& slot : slots) {
+        slot.framesDecoded.store(0, std::memory_order_relaxed);
+        slot.framesEncoded.store(0, std::memory_order_relaxed);
+        slot.unknownIds.store(0, std::memory_order_relaxed);
+        slot.dlcMismatches.store(0, std::memory_order_relaxed);
+        slot.outOfRangeEncodes.store(0, std::memory_order_relaxed);
+        slot.unknownSignals.store(0, std::memory_order_relaxed);
+        for (unsigned int op = 0; op < 3; op++) {
+            for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+                slot.latencyBuckets[op][i].store(0, std::memory_order_relaxed);
+            }
+            slot.latencyCount[op].store(0, std::memory_order_relaxed);
+            slot.latencyTotal[op].store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < messageIds.size(); i++) {
+            slot.framesDecodedPerMessage[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
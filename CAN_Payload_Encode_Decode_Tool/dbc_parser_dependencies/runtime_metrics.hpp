@@ -0,0 +1,135 @@
+//
+//  runtime_metrics.hpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef runtime_metrics_h
+#define runtime_metrics_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// Counters are spread over a fixed number of cache-line sized slots. Every thread
+// writes to its own slot, so counting never contends with other threads
+constexpr unsigned int METRICS_SLOT_COUNT = 16;
+// Latency bucket i holds durations in [2^(i-1), 2^i) nanoseconds, the last bucket is open ended
+constexpr unsigned int LATENCY_BUCKET_COUNT = 32;
+
+enum class MetricsOperation {
+    Parse,
+    Decode,
+    Encode
+};
+
+struct LatencyHistogram {
+    std::array<uint64_t, LATENCY_BUCKET_COUNT> buckets{};
+    uint64_t count{};
+    uint64_t totalNanoseconds{};
+    double meanNanoseconds() const { return count ? static_cast<double>(totalNanoseconds) / count : 0; }
+    // Upper bound of the bucket that contains the given quantile (0 to 1)
+    uint64_t quantileNanoseconds(double quantile) const;
+};
+
+// Point-in-time copy of all counters
+struct MetricsSnapshot {
+    uint64_t framesDecoded{};
+    uint64_t framesEncoded{};
+    uint64_t unknownIds{};
+    uint64_t dlcMismatches{};
+    uint64_t outOfRangeEncodes{};
+    uint64_t unknownSignals{};
+    // <Message id, frames decoded>, only messages that were decoded at least once
+    std::unordered_map<unsigned long, uint64_t> framesDecodedPerId;
+    LatencyHistogram parseLatency;
+    LatencyHistogram decodeLatency;
+    LatencyHistogram encodeLatency;
+    std::string toText() const;
+    std::string toJson() const;
+};
+
+class RuntimeMetrics {
+
+public:
+
+    // Set up one per-message counter per ID. Must be called before counting starts
+    void setMessageIds(const std::vector<unsigned long>& ids);
+    void countDecoded(unsigned int messageIndex) {
+        Slot& slot = localSlot();
+        slot.framesDecoded.fetch_add(1, std::memory_order_relaxed);
+        if (messageIndex < messageIds.size()) {
+            slot.framesDecodedPerMessage[messageIndex].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void countEncoded() { localSlot().framesEncoded.fetch_add(1, std::memory_order_relaxed); }
+    void countUnknownId() { localSlot().unknownIds.fetch_add(1, std::memory_order_relaxed); }
+    void countDlcMismatch() { localSlot().dlcMismatches.fetch_add(1, std::memory_order_relaxed); }
+    void countUnknownSignal() { localSlot().unknownSignals.fetch_add(1, std::memory_order_relaxed); }
+    void countOutOfRange(uint64_t count) {
+        if (count) {
+            localSlot().outOfRangeEncodes.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    void recordLatency(MetricsOperation operation, uint64_t nanoseconds);
+    // Latency histograms cost two clock reads per call, so they are only kept on request
+    void setLatencyTracking(bool enabled) { latencyTracking.store(enabled, std::memory_order_relaxed); }
+    bool isLatencyTracking() const { return latencyTracking.load(std::memory_order_relaxed); }
+    MetricsSnapshot snapshot() const;
+    void reset();
+
+private:
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> framesDecoded{};
+        std::atomic<uint64_t> framesEncoded{};
+        std::atomic<uint64_t> unknownIds{};
+        std::atomic<uint64_t> dlcMismatches{};
+        std::atomic<uint64_t> outOfRangeEncodes{};
+        std::atomic<uint64_t> unknownSignals{};
+        // [operation][bucket], plus count and total time per operation
+        std::atomic<uint64_t> latencyBuckets[3][LATENCY_BUCKET_COUNT]{};
+        std::atomic<uint64_t> latencyCount[3]{};
+        std::atomic<uint64_t> latencyTotal[3]{};
+        std::unique_ptr<std::atomic<uint64_t>[]> framesDecodedPerMessage;
+    };
+    std::atomic<bool> latencyTracking{ false };
+    std::vector<unsigned long> messageIds;
+    std::array<Slot, METRICS_SLOT_COUNT> slots;
+    Slot& localSlot() { return slots[threadSlotIndex()]; }
+    static unsigned int threadSlotIndex();
+
+};
+
+// Records the time between construction and destruction, if latency tracking is on
+class LatencyTimer {
+public:
+    LatencyTimer(RuntimeMetrics& metrics, MetricsOperation operation) :
+        metrics(metrics), operation(operation), isActive(metrics.isLatencyTracking()) {
+        if (isActive) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+    ~LatencyTimer() {
+        if (isActive) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            metrics.recordLatency(operation, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+private:
+    RuntimeMetrics& metrics;
+    MetricsOperation operation;
+    bool isActive;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif /* runtime_metrics_h */
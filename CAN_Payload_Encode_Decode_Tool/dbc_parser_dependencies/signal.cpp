@@ -12,6 +12,18 @@
 #include "signal.hpp"
 #include "pack754.h"
 
+Signal::Signal(const allocator_type& allocator) :
+    name(allocator), unit(allocator), receiversName(allocator), valueDescriptions(allocator) {}
+
+// Assigning keeps the allocator of this signal, so the contents end up in its memory resource
+Signal::Signal(const Signal& other, const allocator_type& allocator) : Signal(allocator) {
+    *this = other;
+}
+
+Signal::Signal(Signal&& other, const allocator_type& allocator) : Signal(allocator) {
+    *this = std::move(other);
+}
+
 void Signal::setSigValueType(const int sigValueTypeIdentifier) {
     if (sigValueTypeIdentifier == 1) {
         sigValueType = ValueType::IeeeFloat;
@@ -22,7 +34,7 @@ void Signal::setSigValueType(const int sigValueTypeIdentifier) {
     else {
         throw std::invalid_argument("Parse failed. "
             "Undefined signal value type identifier for signal \""
-            + name
+            + getName()
             + "\".");
     }
 }
@@ -40,42 +52,44 @@ std::istream& Signal::parseSignalValueDescription(std::istream& in) {
         valueDescriptions_iterator description_itr = valueDescriptions.find(sigValue);
         if (description_itr == valueDescriptions.end()) {
             // Store signal value description
-            valueDescriptions.insert(std::make_pair(sigValue, rawDescription));
+            valueDescriptions.emplace(sigValue, rawDescription);
         }
         else {
             throw std::invalid_argument("Parse failed. "
                 "Found duplicated value description of signal \""
-                + name
+                + getName()
                 + "\".");
         }
     }
     return in;
 }
 
-double Signal::decodeSignal(
-    unsigned char const rawPayload[],
-    unsigned short const MAX_MSG_LEN,
-    unsigned int const messageSize) {
-    int64_t decodedBitSequence = 0;
+uint64_t Signal::extractRawValue(unsigned char const rawPayload[]) const {
+    uint64_t decodedBitSequence = 0;
     uint16_t currentBit = 0;
     // Intel
     if (sigByteOrder == ByteOrder::Intel) {
-        // Change endianness
-        int64_t payload = 0;
-        for (int i = MAX_MSG_LEN; i > 0; i--) {
-            payload <<= 8;
-            payload |= (uint64_t)rawPayload[i - 1];
+        unsigned int firstByte = startBit / CHAR_BIT;
+        unsigned int shift = startBit % CHAR_BIT;
+        unsigned int byteCount = (shift + signalSize + CHAR_BIT - 1) / CHAR_BIT;
+        // Fast path: the signal spans at most 8 bytes, gather them as one little-endian word
+        if (byteCount <= sizeof(uint64_t)) {
+            for (unsigned int i = byteCount; i > 0; i--) {
+                decodedBitSequence <<= CHAR_BIT;
+                decodedBitSequence |= rawPayload[firstByte + i - 1];
+            }
+            decodedBitSequence >>= shift;
         }
-        // Decode
-        uint8_t* data = (uint8_t*)&payload;
-        currentBit = startBit;
-        // Access the corresponding byte and make sure we are reading a bit that is 1
-        for (unsigned short bitpos = 0; bitpos < signalSize; bitpos++) {
-            if (data[currentBit / CHAR_BIT] & (1 << (currentBit % CHAR_BIT))) {
-                // Add dominant bit
-                decodedBitSequence |= (1ULL << bitpos);
+        else {
+            currentBit = startBit;
+            // Access the corresponding byte and make sure we are reading a bit that is 1
+            for (unsigned short bitpos = 0; bitpos < signalSize; bitpos++) {
+                if (rawPayload[currentBit / CHAR_BIT] & (1 << (currentBit % CHAR_BIT))) {
+                    // Add dominant bit
+                    decodedBitSequence |= (1ULL << bitpos);
+                }
+                currentBit++;
             }
-            currentBit++;
         }
     }
     // Motorola MSB
@@ -85,17 +99,36 @@ double Signal::decodeSignal(
         unsigned int translationOffset = 0;
         translationFactor = (startBit / CHAR_BIT);
         translationOffset = (CHAR_BIT - (startBit) % CHAR_BIT - 1);
-        currentBit = translationFactor * CHAR_BIT + translationOffset;
-        // Decode
-        for (unsigned short bitpos = 0; bitpos < signalSize; bitpos++) {
-            if (rawPayload[currentBit / CHAR_BIT] & (1 << ((MAX_BIT_INDEX_uint64_t - currentBit) % CHAR_BIT))) {
-                // Add dominant bit
-                decodedBitSequence |= (1ULL << (signalSize - bitpos - 1));
+        unsigned int byteCount = (translationOffset + signalSize + CHAR_BIT - 1) / CHAR_BIT;
+        // Fast path: the signal spans at most 8 bytes, gather them as one big-endian word
+        if (byteCount <= sizeof(uint64_t)) {
+            for (unsigned int i = 0; i < byteCount; i++) {
+                decodedBitSequence <<= CHAR_BIT;
+                decodedBitSequence |= rawPayload[translationFactor + i];
+            }
+            decodedBitSequence >>= (byteCount * CHAR_BIT - translationOffset - signalSize);
+        }
+        else {
+            currentBit = translationFactor * CHAR_BIT + translationOffset;
+            // Decode
+            for (unsigned short bitpos = 0; bitpos < signalSize; bitpos++) {
+                if (rawPayload[currentBit / CHAR_BIT] & (1 << ((MAX_BIT_INDEX_uint64_t - currentBit) % CHAR_BIT))) {
+                    // Add dominant bit
+                    decodedBitSequence |= (1ULL << (signalSize - bitpos - 1));
+                }
+                currentBit++;
             }
-            currentBit++;
         }
     }
+    // Drop the bits that belong to neighbouring signals
+    if (signalSize < sizeof(uint64_t) * CHAR_BIT) {
+        decodedBitSequence &= (1ULL << signalSize) - 1;
+    }
+    return decodedBitSequence;
+}
 
+double Signal::rawToPhysical(uint64_t rawValue) const {
+    int64_t decodedBitSequence = static_cast<int64_t>(rawValue);
     double decodedValue = 0;
     if ((sigValueType == ValueType::Signed) && (decodedBitSequence & (1ULL << (signalSize - 1)))) {
         // Sign extend for signed signal values
@@ -116,10 +149,18 @@ double Signal::decodeSignal(
     return decodedValue;
 }
 
+// The bit layout is computed when the signal is parsed, so the lengths are no longer needed
+double Signal::decodeSignal(
+    unsigned char const rawPayload[],
+    unsigned short const,
+    unsigned int const) const {
+    return rawToPhysical(extractRawValue(rawPayload));
+}
+
 void Signal::encodeSignal(
     const double physicalValue,
     unsigned char encodedPayload[],
-    unsigned short const MAX_MSG_LEN) {
+    unsigned short const MAX_MSG_LEN) const {
     int64_t rawValue = 0;
     if (sigValueType == ValueType::IeeeDouble) {
         // Pack a floating point number into IEEE-754 format
@@ -131,7 +172,48 @@ void Signal::encodeSignal(
     else {
         rawValue = static_cast<int64_t>((physicalValue - offset) / factor);
     }
-    uint8_t* rawPayload = (uint8_t*)&rawValue;
+    insertRawValue(static_cast<uint64_t>(rawValue), encodedPayload, MAX_MSG_LEN);
+}
+
+void Signal::insertRawValue(
+    uint64_t const rawBits,
+    unsigned char encodedPayload[],
+    unsigned short const MAX_MSG_LEN) const {
+    // Fast path: shift the raw bits into place as one word and write each byte through
+    // the mask of the signal, which clears the old bits and keeps those of other signals
+    uint64_t word = 0;
+    bool isWordAligned = false;
+    if (sigByteOrder == ByteOrder::Intel) {
+        unsigned int shift = startBit % CHAR_BIT;
+        if (layoutByteCount <= sizeof(uint64_t) && shift + signalSize <= sizeof(uint64_t) * CHAR_BIT) {
+            // Byte i of the word goes to payload byte layoutFirstByte + i
+            word = rawBits << shift;
+            isWordAligned = true;
+        }
+    }
+    else {
+        unsigned int translationOffset = CHAR_BIT - startBit % CHAR_BIT - 1;
+        if (layoutByteCount <= sizeof(uint64_t) && translationOffset + signalSize <= sizeof(uint64_t) * CHAR_BIT) {
+            // Big-endian: the last byte of the signal is the lowest byte of the word
+            uint64_t bigEndianWord = rawBits << (layoutByteCount * CHAR_BIT - translationOffset - signalSize);
+            for (unsigned int i = 0; i < layoutByteCount; i++) {
+                word |= ((bigEndianWord >> ((layoutByteCount - i - 1) * CHAR_BIT)) & 0xFF) << (i * CHAR_BIT);
+            }
+            isWordAligned = true;
+        }
+    }
+    if (isWordAligned) {
+        for (unsigned int i = 0; i < layoutByteCount && layoutFirstByte + i < MAX_MSG_LEN; i++) {
+            uint8_t mask = layoutByteMasks[i];
+            unsigned char& payloadByte = encodedPayload[layoutFirstByte + i];
+            payloadByte = static_cast<unsigned char>((payloadByte & ~mask) | ((word >> (i * CHAR_BIT)) & mask));
+        }
+        return;
+    }
+    for (unsigned int i = 0; i < layoutByteCount && layoutFirstByte + i < MAX_MSG_LEN; i++) {
+        encodedPayload[layoutFirstByte + i] &= static_cast<unsigned char>(~layoutByteMasks[i]);
+    }
+    const uint8_t* rawPayload = reinterpret_cast<const uint8_t*>(&rawBits);
     if (sigByteOrder == ByteOrder::Intel) { // Intel
         uint16_t currentRawBit = 0;
         // Encode
@@ -167,6 +249,34 @@ void Signal::encodeSignal(
     }
 }
 
+void Signal::computeLayout() {
+    // Walk the bits of the signal the same way the bitwise decoder does
+    // and collect them per byte. Only the first bytes of a signal can be touched
+    uint8_t masks[MAX_SIGNAL_BYTES + 1] = {};
+    unsigned int size = std::min<unsigned int>(signalSize, sizeof(uint64_t) * CHAR_BIT);
+    unsigned int firstByte = startBit / CHAR_BIT;
+    unsigned int lastByte = firstByte;
+    for (unsigned int bitpos = 0; bitpos < size; bitpos++) {
+        unsigned int byteIndex = 0;
+        unsigned int bitInByte = 0;
+        if (sigByteOrder == ByteOrder::Intel) {
+            byteIndex = (startBit + bitpos) / CHAR_BIT;
+            bitInByte = (startBit + bitpos) % CHAR_BIT;
+        }
+        else {
+            // Motorola sequential bit numbering, from the MSB down to the LSB
+            unsigned int sequentialBit = firstByte * CHAR_BIT + (CHAR_BIT - startBit % CHAR_BIT - 1) + bitpos;
+            byteIndex = sequentialBit / CHAR_BIT;
+            bitInByte = CHAR_BIT - sequentialBit % CHAR_BIT - 1;
+        }
+        masks[byteIndex - firstByte] |= static_cast<uint8_t>(1 << bitInByte);
+        lastByte = std::max(lastByte, byteIndex);
+    }
+    layoutFirstByte = firstByte;
+    layoutByteCount = size == 0 ? 0 : lastByte - firstByte + 1;
+    std::copy(masks, masks + MAX_SIGNAL_BYTES, layoutByteMasks);
+}
+
 std::istream& operator>>(std::istream& in, Signal& sig) {
     // Read signal name
     in >> sig.name;
@@ -176,7 +286,7 @@ std::istream& operator>>(std::istream& in, Signal& sig) {
     if (rawString != ":") {
         sig.sigSignalType = SignalType::Multiplexed;
         // in >> rawString; // Comment the exception and uncomment this line if you still want to proceed.
-        throw std::invalid_argument("Parse failed. Signal \"" + sig.name + "\" may not be a normal signal."
+        throw std::invalid_argument("Parse failed. Signal \"" + sig.getName() + "\" may not be a normal signal."
             " Note: This tool does not currently support parsing multiplexer and multiplexed signals.");
     }
     else {
@@ -195,7 +305,7 @@ std::istream& operator>>(std::istream& in, Signal& sig) {
     else if (rawByteOrderValue == 1) { sig.sigByteOrder = ByteOrder::Intel; }
     else {
         throw std::invalid_argument("Parse failed. Unable to parse byte order "
-            "of signal \"" + sig.name + "\".");
+            "of signal \"" + sig.getName() + "\".");
     }
     // Read value type
     char rawChar;
@@ -204,7 +314,7 @@ std::istream& operator>>(std::istream& in, Signal& sig) {
     else if (rawChar == '-') { sig.sigValueType = ValueType::Signed; }
     else {
         throw std::invalid_argument("Parse failed. Unable to parse value type "
-            "of signal \"" + sig.name + "\".");
+            "of signal \"" + sig.getName() + "\".");
     }
     // Read factor and offset
     in.ignore(2);
@@ -227,9 +337,10 @@ std::istream& operator>>(std::istream& in, Signal& sig) {
         std::stringstream tempStream(rawString);
         std::string item;
         while (std::getline(tempStream, item, ',')) {
-            sig.receiversName.push_back(item);
+            sig.receiversName.emplace_back(item);
         }
     }
     in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    sig.computeLayout();
     return in;
 }
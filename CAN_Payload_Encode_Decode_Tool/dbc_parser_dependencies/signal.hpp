@@ -11,11 +11,20 @@
 #include <string>
 #include <vector>
 #include <iosfwd>
+#include <climits>
+#include <cstdint>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
+#include <memory_resource>
 #include "dbc_parser_helper.hpp"
 
 constexpr int MAX_BIT_INDEX_uint64_t = (sizeof(uint64_t) * CHAR_BIT) - 1;
+// A signal of up to 64 bits that does not start on a byte boundary touches at most 9 bytes
+constexpr unsigned int MAX_SIGNAL_BYTES = sizeof(uint64_t) + 1;
+
+// Dense index of a signal across the whole database, assigned once parsing completes
+typedef unsigned int SignalHandle;
 
 enum class ByteOrder {
 	NotSet,
@@ -39,8 +48,21 @@ class Signal {
 
 public:
 
-	std::string getName() const { return name; }
-	std::string getUnit() const { return unit; }
+	// Strings and containers of a signal are allocated from the memory resource of its message
+	typedef std::pmr::polymorphic_allocator<char> allocator_type;
+	Signal() = default;
+	explicit Signal(const allocator_type& allocator);
+	Signal(const Signal& other, const allocator_type& allocator);
+	Signal(Signal&& other, const allocator_type& allocator);
+	Signal(const Signal&) = default;
+	Signal(Signal&&) = default;
+	Signal& operator=(const Signal&) = default;
+	Signal& operator=(Signal&&) = default;
+	std::string getName() const { return std::string(name); }
+	// Same as getName() but without copying the name
+	std::string_view getNameView() const { return name; }
+	std::string getUnit() const { return std::string(unit); }
+	std::string_view getUnitView() const { return unit; }
 	double getFactor() const { return factor; }
 	double getOffset() const { return offset; }
 	double getMinValue() const { return minValue; }
@@ -50,28 +72,66 @@ public:
 	ByteOrder getByteOrder() const { return sigByteOrder; }
 	ValueType getValueTypes() const { return sigValueType; }
 	std::optional<double> getInitialValue() const { return initialValue; }
+	// Range check of every encoder: the value is converted to raw and compared with min and max
+	bool isInRange(double const physicalValue) const {
+		double rawValue = (physicalValue - offset) / factor;
+		return rawValue <= maxValue && rawValue >= minValue;
+	}
+	// Position of the signal inside its message, in DBC file order
+	unsigned int getPosition() const { return position; }
+	SignalHandle getHandle() const { return handle; }
+	// Bit layout in the payload, computed once when the signal is parsed
+	// The signal occupies the bits getByteMask(i) of payload byte getFirstByte() + i,
+	// for i < getByteCount()
+	unsigned int getFirstByte() const { return layoutFirstByte; }
+	unsigned int getByteCount() const { return layoutByteCount; }
+	uint8_t getByteMask(unsigned int const i) const { return i < layoutByteCount ? layoutByteMasks[i] : 0; }
+	// True if any bit of the signal differs between the two payloads
+	bool isChanged(unsigned char const previousPayload[], unsigned char const currentPayload[]) const {
+		for (unsigned int i = 0; i < layoutByteCount; i++) {
+			unsigned int byteIndex = layoutFirstByte + i;
+			if ((previousPayload[byteIndex] ^ currentPayload[byteIndex]) & layoutByteMasks[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
 	// Get names of all the nodes that receives this signal
-	std::vector<std::string> getReceiversName() const { return receiversName; }
+	std::vector<std::string> getReceiversName() const { return std::vector<std::string>(receiversName.begin(), receiversName.end()); }
+	// <raw value, label of the value>
+	const std::pmr::unordered_map<double, std::pmr::string>& getValueDescriptions() const { return valueDescriptions; }
 	void setInitialValue(const double& initialValue) { this->initialValue = initialValue; }
 	void setSigValueType(const int sigValueTypeIdentifier);
+	void setPosition(const unsigned int position) { this->position = position; }
+	void setHandle(const SignalHandle handle) { this->handle = handle; }
 	// Decode/Encode
+	// Extract the raw bits of the signal, right aligned and without sign extension
+	uint64_t extractRawValue(unsigned char const rawPayload[]) const;
+	// Convert raw bits returned by extractRawValue into the physical value
+	double rawToPhysical(uint64_t rawValue) const;
 	double decodeSignal(unsigned char const rawPayload[],
 		unsigned short const MAX_MSG_LEN,
-		unsigned int const messageSize);
+		unsigned int const messageSize) const;
+	// Replaces the bits of the signal in encodedPayload and leaves all other bits alone
 	void encodeSignal(const double physicalValue,
 		unsigned char encodedPayload[],
-		unsigned short const MAX_MSG_LEN);
+		unsigned short const MAX_MSG_LEN) const;
+	// Counterpart of extractRawValue: writes the lowest getSignalSize() bits of rawBits
+	// into the signal's bits of encodedPayload, the same way encodeSignal does
+	void insertRawValue(uint64_t const rawBits,
+		unsigned char encodedPayload[],
+		unsigned short const MAX_MSG_LEN) const;
 	std::istream& parseSignalValueDescription(std::istream& in);
 	// Operator overload, allows parsing of signals info
 	friend std::istream& operator>>(std::istream& in, Signal& sig);
 
 private:
 
-	typedef std::unordered_map<double, std::string>::iterator valueDescriptions_iterator;
+	typedef std::pmr::unordered_map<double, std::pmr::string>::iterator valueDescriptions_iterator;
 	// Name of the signal
-	std::string name{};
+	std::pmr::string name{};
 	// Represents the physical unit of the signal, which is a string type
-	std::string unit{};
+	std::pmr::string unit{};
 	// Two variables: factor and offset
 	// Used to convert between the original value of the signal and the physical value
 	// Conversion formula: physical value = original value * factor + offset
@@ -92,10 +152,19 @@ private:
 	ValueType sigValueType = ValueType::NotSet;
 	SignalType sigSignalType = SignalType::NotSet;
 	// Names of all the nodes that receives this signal
-	std::vector<std::string> receiversName{};
+	std::pmr::vector<std::pmr::string> receiversName{};
+	// Position inside the message and global handle, see getPosition() and getHandle()
+	unsigned int position{};
+	SignalHandle handle{};
+	// See getFirstByte(), getByteCount() and getByteMask()
+	unsigned int layoutFirstByte{};
+	unsigned int layoutByteCount{};
+	uint8_t layoutByteMasks[MAX_SIGNAL_BYTES]{};
 	// Signal value descriptions: define encodings for specific signal raw values
 	// <physical value, label of the value>
-	std::unordered_map<double, std::string> valueDescriptions;
+	std::pmr::unordered_map<double, std::pmr::string> valueDescriptions;
+
+	void computeLayout();
 };
 
 #endif /* SIGNAL_H */
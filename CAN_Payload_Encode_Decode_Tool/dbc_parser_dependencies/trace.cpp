@@ -0,0 +1,187 @@
+//
+//  trace.cpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "trace.hpp"
+#include "output_buffer.hpp"
+
+namespace {
+
+    // Written by its own thread only. The events are atomics so that an export
+    // from another thread can read them while they are being overwritten
+    struct TraceBuffer {
+        struct Event {
+            std::atomic<const char*> name{ nullptr };
+            std::atomic<uint64_t> start{};
+            std::atomic<uint64_t> duration{};
+        };
+        explicit TraceBuffer(unsigned int threadNumber) :
+            threadNumber(threadNumber), events(std::make_unique<Event[]>(TRACE_BUFFER_EVENT_COUNT)) {}
+        unsigned int threadNumber;
+        // Events recorded so far. Event n is in events[n % TRACE_BUFFER_EVENT_COUNT]
+        std::atomic<uint64_t> writeCount{ 0 };
+        // Events before this one were cleared
+        std::atomic<uint64_t> clearedCount{ 0 };
+        std::unique_ptr<Event[]> events;
+    };
+
+    // Buffers stay registered after their thread exits, so its events can still be exported.
+    // The buffer of an exited thread is handed to the next new thread, which goes on writing
+    // into the same ring under the same thread number, so memory is bounded by the number of
+    // threads alive at the same time, not by the number of threads ever started
+    struct TraceRegistry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<TraceBuffer> > buffers;
+        std::vector<TraceBuffer*> freeBuffers;
+    };
+
+    TraceRegistry& registry() {
+        static TraceRegistry instance;
+        return instance;
+    }
+
+    // Plain thread_locals need no initialization guard on every span
+    thread_local TraceBuffer* threadBuffer = nullptr;
+    // Set once the buffer was handed back, spans recorded later in the thread exit are dropped
+    thread_local bool isThreadExiting = false;
+
+    // Hands the buffer of the thread back to the registry when the thread exits
+    struct BufferRelease {
+        ~BufferRelease() {
+            TraceRegistry& traceRegistry = registry();
+            std::lock_guard<std::mutex> lock(traceRegistry.mutex);
+            traceRegistry.freeBuffers.push_back(threadBuffer);
+            threadBuffer = nullptr;
+            isThreadExiting = true;
+        }
+    };
+
+    // First span of a thread. Returns nullptr while the thread exits
+    TraceBuffer* acquireBuffer() {
+        if (isThreadExiting) {
+            return nullptr;
+        }
+        TraceRegistry& traceRegistry = registry();
+        {
+            std::lock_guard<std::mutex> lock(traceRegistry.mutex);
+            if (!traceRegistry.freeBuffers.empty()) {
+                threadBuffer = traceRegistry.freeBuffers.back();
+                traceRegistry.freeBuffers.pop_back();
+            }
+            else {
+                auto created = std::make_shared<TraceBuffer>(static_cast<unsigned int>(traceRegistry.buffers.size() + 1));
+                traceRegistry.buffers.push_back(created);
+                threadBuffer = created.get();
+            }
+        }
+        // Constructed here, on the first span only, so its destructor runs at thread exit
+        thread_local BufferRelease release;
+        return threadBuffer;
+    }
+
+    struct CopiedEvent {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+    };
+
+    // Copy out the events of a buffer, without the ones the owner overwrote in the meantime
+    void copyEvents(const TraceBuffer& buffer, std::vector<CopiedEvent>& out) {
+        out.clear();
+        uint64_t end = buffer.writeCount.load(std::memory_order_acquire);
+        uint64_t begin = std::max(buffer.clearedCount.load(std::memory_order_relaxed),
+            end - std::min<uint64_t>(end, TRACE_BUFFER_EVENT_COUNT));
+        for (uint64_t n = begin; n < end; n++) {
+            const TraceBuffer::Event& event = buffer.events[n % TRACE_BUFFER_EVENT_COUNT];
+            out.push_back({ event.name.load(std::memory_order_relaxed),
+                event.start.load(std::memory_order_relaxed),
+                event.duration.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The owner may be writing event `after` already, which replaces event after - TRACE_BUFFER_EVENT_COUNT
+        uint64_t after = buffer.writeCount.load(std::memory_order_relaxed);
+        if (after + 1 > begin + TRACE_BUFFER_EVENT_COUNT) {
+            size_t overwritten = static_cast<size_t>(std::min<uint64_t>(
+                after + 1 - TRACE_BUFFER_EVENT_COUNT - begin, out.size()));
+            out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(overwritten));
+        }
+    }
+
+}
+
+uint64_t Tracer::now() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Tracer::record(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds) {
+    TraceBuffer* threadLocalBuffer = threadBuffer;
+    if (threadLocalBuffer == nullptr) {
+        threadLocalBuffer = acquireBuffer();
+        if (threadLocalBuffer == nullptr) {
+            return;
+        }
+    }
+    TraceBuffer& buffer = *threadLocalBuffer;
+    uint64_t n = buffer.writeCount.load(std::memory_order_relaxed);
+    TraceBuffer::Event& event = buffer.events[n % TRACE_BUFFER_EVENT_COUNT];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(startNanoseconds, std::memory_order_relaxed);
+    event.duration.store(endNanoseconds - startNanoseconds, std::memory_order_relaxed);
+    buffer.writeCount.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) {
+    std::vector<std::shared_ptr<TraceBuffer> > buffers;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        buffers = registry().buffers;
+    }
+    OutputBuffer output(out);
+    output.append("{\"traceEvents\":[");
+    bool isFirst = true;
+    std::vector<CopiedEvent> events;
+    for (auto& buffer : buffers) {
+        copyEvents(*buffer, events);
+        if (events.empty()) {
+            continue;
+        }
+        output.append(isFirst ? "\n" : ",\n");
+        isFirst = false;
+        output.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+        output.appendNumber(buffer->threadNumber);
+        output.append(",\"args\":{\"name\":\"Thread ");
+        output.appendNumber(buffer->threadNumber);
+        output.append("\"}}");
+        for (const CopiedEvent& event : events) {
+            output.append(",\n{\"name\":");
+            output.appendJsonString(event.name);
+            // Timestamps are in microseconds
+            output.append(",\"cat\":\"dbc\",\"ph\":\"X\",\"ts\":");
+            output.appendNumber(static_cast<double>(event.start) / 1000);
+            output.append(",\"dur\":");
+            output.appendNumber(static_cast<double>(event.duration) / 1000);
+            output.append(",\"pid\":1,\"tid\":");
+            output.appendNumber(buffer->threadNumber);
+            output.append('}');
+        }
+    }
+    output.append("\n],\"displayTimeUnit\":\"ns\"}\n");
+    output.flush();
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for (auto& buffer : registry().buffers) {
+        buffer->clearedCount.store(buffer->writeCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
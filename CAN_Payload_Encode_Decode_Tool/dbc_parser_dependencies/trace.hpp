@@ -0,0 +1,111 @@
+//
+//  trace.hpp
+//  CAN_Payload_Encode_Decode_Tool
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef trace_h
+#define trace_h
+
+#include <atomic>
+#include <iosfwd>
+#include <cstdint>
+
+// Events kept per thread. When a buffer is full the oldest events are overwritten
+constexpr size_t TRACE_BUFFER_EVENT_COUNT = 1 << 16;
+
+// Collects trace spans in one ring buffer per thread and exports them in the Chrome
+// trace event format, to be opened in chrome://tracing or Perfetto.
+// The buffer of a thread that exited is reused by the next thread that records a span
+// Spans are only recorded where DBC_TRACE_SCOPE is compiled in, see below
+class Tracer {
+
+public:
+
+    // On by default. Turning it off leaves a flag check per span
+    static void setEnabled(bool isOn) { enabled.store(isOn, std::memory_order_relaxed); }
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+    // Nanoseconds since the first call
+    static uint64_t now();
+    // name must outlive the tracer, e.g. a string literal
+    static void record(const char* name, uint64_t startNanoseconds, uint64_t endNanoseconds);
+    // Events of all threads, including threads that have exited. Safe to call while
+    // other threads are recording, events overwritten during the export are left out
+    static void writeChromeTrace(std::ostream& out);
+    // Drop all events recorded so far
+    static void clear();
+
+private:
+
+    inline static std::atomic<bool> enabled{ true };
+
+};
+
+// Records the time between construction and destruction as one span
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), isActive(Tracer::isEnabled()) {
+        if (isActive) {
+            start = Tracer::now();
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    ~TraceScope() {
+        if (isActive) {
+            Tracer::record(name, start, Tracer::now());
+        }
+    }
+private:
+    const char* name;
+    bool isActive;
+    uint64_t start = 0;
+};
+
+// Consecutive spans in one scope: entering a phase ends the previous one, unless it has
+// the same name. Used for loops where runs of similar iterations form a phase
+class TracePhases {
+public:
+    TracePhases() = default;
+    TracePhases(const TracePhases&) = delete;
+    TracePhases& operator=(const TracePhases&) = delete;
+    ~TracePhases() { end(); }
+    void enter(const char* phaseName) {
+        if (phaseName != name) {
+            end();
+            name = phaseName;
+            if (Tracer::isEnabled()) {
+                start = Tracer::now();
+            }
+            else {
+                name = nullptr;
+            }
+        }
+    }
+    void end() {
+        if (name != nullptr) {
+            Tracer::record(name, start, Tracer::now());
+            name = nullptr;
+        }
+    }
+private:
+    const char* name = nullptr;
+    uint64_t start = 0;
+};
+
+// Spans cost two clock reads and a buffer write, so they are compiled out unless
+// DBC_PARSER_ENABLE_TRACING is defined
+#ifdef DBC_PARSER_ENABLE_TRACING
+#define DBC_TRACE_CONCAT_INNER(a, b) a##b
+#define DBC_TRACE_CONCAT(a, b) DBC_TRACE_CONCAT_INNER(a, b)
+#define DBC_TRACE_SCOPE(name) TraceScope DBC_TRACE_CONCAT(dbcTraceScope, __LINE__)(name)
+#define DBC_TRACE_PHASES(phases) TracePhases phases
+#define DBC_TRACE_PHASE(phases, name) phases.enter(name)
+#else
+#define DBC_TRACE_SCOPE(name) do {} while (0)
+#define DBC_TRACE_PHASES(phases) do {} while (0)
+#define DBC_TRACE_PHASE(phases, name) do {} while (0)
+#endif
+
+#endif /* trace_h */
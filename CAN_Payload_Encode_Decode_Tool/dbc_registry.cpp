@@ -0,0 +1,78 @@
+/*
+ *  dbc_registry.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include "dbc_registry.hpp"
+
+namespace {
+
+    std::string readFileContent(const std::string& filePath) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file) {
+            throw std::invalid_argument("Parse Failed. Could not open CAN database file.");
+        }
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+}
+
+const DbcParser& DbcRegistry::load(const std::string& filePath, const std::vector<unsigned int>& channels,
+    LoadMode mode) {
+    for (unsigned int channel : channels) {
+        if (channelDatabases.find(channel) != channelDatabases.end()) {
+            throw std::invalid_argument("Load failed. Channel "
+                + std::to_string(channel) + " already has a CAN database.");
+        }
+    }
+    std::string content = readFileContent(filePath);
+    size_t contentSize = content.size();
+    size_t contentHash = std::hash<std::string_view>{}(content);
+    // Only shared with a database of the same load mode, the modes behave differently on errors
+    const DbcParser* database = nullptr;
+    for (const LoadedFile& loadedFile : loadedFiles) {
+        if (loadedFile.mode == mode && loadedFile.size == contentSize && loadedFile.contentHash == contentHash
+            && (loadedFile.path == filePath || readFileContent(loadedFile.path) == content)) {
+            database = loadedFile.database;
+            break;
+        }
+    }
+    if (database == nullptr) {
+        // Parsed from the content read above, so the file is read once
+        std::istringstream in(std::move(content));
+        auto parsed = std::make_unique<DbcParser>();
+        if (!parsed->parse(in, mode)) {
+            throw std::invalid_argument("Load failed. Could not parse CAN database file \"" + filePath + "\".");
+        }
+        database = parsed.get();
+        databases.push_back(std::move(parsed));
+        loadedFiles.push_back({ filePath, mode, contentSize, contentHash, database });
+    }
+    for (unsigned int channel : channels) {
+        channelDatabases.emplace(channel, database);
+        addRoutes(channel, *database);
+    }
+    return *database;
+}
+
+const DbcParser* DbcRegistry::getDatabase(unsigned int channel) const {
+    auto channel_itr = channelDatabases.find(channel);
+    if (channel_itr == channelDatabases.end()) {
+        return nullptr;
+    }
+    return channel_itr->second;
+}
+
+void DbcRegistry::addRoutes(unsigned int channel, const DbcParser& database) {
+    routes.reserve(routes.size() + database.messageLibrary.size());
+    for (auto& message : database.messageLibrary) {
+        routes.emplace(routeKey(channel, message.first), Route{ &database, &message.second });
+    }
+}
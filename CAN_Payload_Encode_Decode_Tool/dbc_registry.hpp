@@ -0,0 +1,112 @@
+/*
+ *  dbc_registry.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef DBC_REGISTRY_HPP
+#define DBC_REGISTRY_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+
+// Several CAN databases, each bound to one or more bus channels.
+// A DBC file that is loaded for several channels, or an identical copy of it, is only
+// parsed once and shared, as long as it is loaded with the same LoadMode.
+// All messages of all channels are kept in one table keyed by (channel, message ID),
+// so decoding a frame from any bus is a single lookup
+class DbcRegistry {
+
+public:
+
+    // Parse a DBC file and bind it to the given channels. Returns the database, which is
+    // shared with any file of the same content loaded before in the same mode
+    // Throws std::invalid_argument if a channel already has a database or the file cannot be parsed
+    const DbcParser& load(const std::string& filePath, const std::vector<unsigned int>& channels,
+        LoadMode mode = LoadMode::Full);
+    // Database bound to a channel, nullptr if there is none
+    const DbcParser* getDatabase(unsigned int channel) const;
+    // Number of distinct databases, files with identical content and load mode count once
+    size_t getDatabaseCount() const { return databases.size(); }
+    // Decode one frame with the database of its channel. The visitor is called as
+    // visitor(const Signal&, double physicalValue) once for every signal of the message
+    // Frames of channels without a database are reported as CodecStatus::UnknownMessage
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeSignals(
+        unsigned int channel,
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        SignalVisitor&& visitor
+    ) const {
+        auto route_itr = routes.find(routeKey(channel, msgId));
+        if (route_itr != routes.end()) {
+            const Route& route = route_itr->second;
+            LatencyTimer timer(*route.database->metrics, MetricsOperation::Decode);
+            return route.database->tryDecodeMessage(route.message, msgSize, payload,
+                std::forward<SignalVisitor>(visitor));
+        }
+        // Not in the table, but a J1939 database can still match it by PGN. This also
+        // counts the unknown ID in the metrics of the database
+        const DbcParser* database = getDatabase(channel);
+        if (database != nullptr) {
+            return database->tryDecodeSignals(msgId, msgSize, payload,
+                std::forward<SignalVisitor>(visitor));
+        }
+        return CodecStatus::UnknownMessage;
+    }
+    // Decode a batch of frames from mixed channels. The visitor is called as
+    // visitor(const CanFrame&, const Signal&, double physicalValue)
+    // Returns the number of frames that were decoded
+    template <typename FrameSignalVisitor>
+    size_t decodeBatch(const CanFrame frames[], size_t frameCount, FrameSignalVisitor&& visitor) const {
+        DBC_TRACE_SCOPE("decodeBatch");
+        size_t decodedCount = 0;
+        for (size_t i = 0; i < frameCount; i++) {
+            const CanFrame& frame = frames[i];
+            CodecStatus status = tryDecodeSignals(frame.channel, frame.id, frame.size, frame.payload,
+                [&frame, &visitor](const Signal& sig, double value) {
+                    visitor(frame, sig, value);
+                });
+            if (status == CodecStatus::Ok) {
+                decodedCount++;
+            }
+        }
+        return decodedCount;
+    }
+
+private:
+
+    struct Route {
+        const DbcParser* database = nullptr;
+        const Message* message = nullptr;
+    };
+    // Content of every loaded file is identified by its size and hash before comparing it byte by byte
+    struct LoadedFile {
+        std::string path;
+        LoadMode mode = LoadMode::Full;
+        size_t size = 0;
+        size_t contentHash = 0;
+        const DbcParser* database = nullptr;
+    };
+    // Parsers are behind pointers, so routes stay valid when more databases are loaded
+    std::vector<std::unique_ptr<DbcParser> > databases;
+    std::vector<LoadedFile> loadedFiles;
+    std::unordered_map<unsigned int, const DbcParser*> channelDatabases;
+    // <(channel << 32) | message id, database and message>
+    std::unordered_map<uint64_t, Route> routes;
+
+    static uint64_t routeKey(unsigned int channel, unsigned long msgId) {
+        return (static_cast<uint64_t>(channel) << 32) | (msgId & 0xFFFFFFFFUL);
+    }
+    void addRoutes(unsigned int channel, const DbcParser& database);
+
+};
+
+#endif
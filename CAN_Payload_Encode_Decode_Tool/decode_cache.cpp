@@ -0,0 +1,138 @@
+/*
+ *  decode_cache.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <bit>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "decode_cache.hpp"
+
+DecodeCache::DecodeCache(const DbcParser& dbcFile, size_t maxEntries, unsigned int shardCount) : dbcFile(&dbcFile) {
+    if (maxEntries < DECODE_CACHE_WAYS || shardCount == 0) {
+        throw std::invalid_argument("Decode cache failed. It needs at least "
+            + std::to_string(DECODE_CACHE_WAYS) + " entries and one shard.");
+    }
+    // Round down, so the cache never holds more than maxEntries frames
+    size_t setTotal = maxEntries / DECODE_CACHE_WAYS;
+    size_t actualShardCount = std::bit_floor(std::min<size_t>(shardCount, setTotal));
+    size_t setCount = std::bit_floor(setTotal / actualShardCount);
+    shards = std::make_unique<Shard[]>(actualShardCount);
+    shardMask = actualShardCount - 1;
+    setMask = setCount - 1;
+    for (size_t i = 0; i < actualShardCount; i++) {
+        shards[i].entries.resize(setCount * DECODE_CACHE_WAYS);
+    }
+}
+
+uint64_t DecodeCache::hashFrame(unsigned long msgId, unsigned int msgSize, unsigned char const payload[]) {
+    uint64_t hash = (static_cast<uint64_t>(msgId) << 8 | msgSize) * 0x9E3779B97F4A7C15ULL;
+    unsigned int i = 0;
+    for (; i + sizeof(uint64_t) <= msgSize; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, payload + i, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 29;
+    }
+    if (i < msgSize) {
+        uint64_t word = 0;
+        std::memcpy(&word, payload + i, msgSize - i);
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+    }
+    // Mix the high bits, which pick the shard, into the low bits, which pick the set
+    return hash ^ (hash >> 31);
+}
+
+DecodeCache::Entry* DecodeCache::find(Shard& shard, uint64_t hash, unsigned long msgId, unsigned int msgSize,
+    unsigned char const payload[]) {
+    Entry* set = &shard.entries[(hash & setMask) * DECODE_CACHE_WAYS];
+    for (unsigned int way = 0; way < DECODE_CACHE_WAYS; way++) {
+        Entry& entry = set[way];
+        if (entry.isValid && entry.hash == hash && entry.msgId == msgId && entry.msgSize == msgSize
+            && std::memcmp(entry.payload.data(), payload, msgSize) == 0) {
+            entry.lastUse = ++shard.useCounter;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+DecodeCache::Entry& DecodeCache::replace(Shard& shard, uint64_t hash, unsigned long msgId, unsigned int msgSize,
+    unsigned char const payload[]) {
+    Entry* set = &shard.entries[(hash & setMask) * DECODE_CACHE_WAYS];
+    Entry* victim = set;
+    for (unsigned int way = 0; way < DECODE_CACHE_WAYS; way++) {
+        if (!set[way].isValid) {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].lastUse < victim->lastUse) {
+            victim = &set[way];
+        }
+    }
+    if (victim->isValid) {
+        shard.evictions++;
+        shard.entryCount--;
+    }
+    victim->isValid = false;
+    victim->hash = hash;
+    victim->lastUse = ++shard.useCounter;
+    victim->msgId = msgId;
+    victim->msgSize = msgSize;
+    std::memcpy(victim->payload.data(), payload, msgSize);
+    // Keeps its capacity, so a replaced entry does not allocate again
+    victim->values.clear();
+    return *victim;
+}
+
+CodecStatus DecodeCache::tryDecode(
+    unsigned long msgId,
+    unsigned int msgSize,
+    unsigned char const payload[],
+    std::unordered_map<std::string, double>& result) {
+    result.clear();
+    return tryDecodeSignals(msgId, msgSize, payload,
+        [&result](const Signal& sig, double value) {
+            result.emplace(sig.getName(), value);
+        });
+}
+
+DecodeCacheStatistics DecodeCache::getStatistics() const {
+    DecodeCacheStatistics statistics;
+    for (size_t i = 0; i <= shardMask; i++) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        statistics.hits += shard.hits;
+        statistics.misses += shard.misses;
+        statistics.evictions += shard.evictions;
+        statistics.entryCount += shard.entryCount;
+        statistics.capacity += shard.entries.size();
+    }
+    statistics.bypasses = bypasses.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void DecodeCache::resetStatistics() {
+    for (size_t i = 0; i <= shardMask; i++) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.hits = 0;
+        shard.misses = 0;
+        shard.evictions = 0;
+    }
+    bypasses.store(0, std::memory_order_relaxed);
+}
+
+void DecodeCache::clear() {
+    for (size_t i = 0; i <= shardMask; i++) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& entry : shard.entries) {
+            entry.isValid = false;
+        }
+        shard.entryCount = 0;
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ *  decode_cache.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef DECODE_CACHE_HPP
+#define DECODE_CACHE_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+
+// Number of entries that one payload hash can be stored in
+constexpr unsigned int DECODE_CACHE_WAYS = 4;
+
+struct DecodeCacheStatistics {
+    uint64_t hits{};
+    uint64_t misses{};
+    // Valid entries that were replaced by a newer frame
+    uint64_t evictions{};
+    // Frames decoded without the cache because their shard was busy
+    uint64_t bypasses{};
+    size_t entryCount{};
+    size_t capacity{};
+    double hitRate() const {
+        uint64_t lookups = hits + misses + bypasses;
+        return lookups ? static_cast<double>(hits) / lookups : 0;
+    }
+};
+
+// Remembers the decoded signals of recent frames, keyed by message ID, size and payload bytes,
+// so a frame that repeats byte for byte is answered without extracting its signals again.
+// The entries are split into shards by payload hash, each with its own lock. A thread never
+// waits for another one: if the shard of a frame is busy, the frame is decoded without the cache.
+// Every shard is a set associative table, a full set replaces its least recently used entry.
+// Only frames that decode with CodecStatus::Ok are cached. Frames answered from the cache
+// are counted in the runtime metrics of the database like any decoded frame
+class DecodeCache {
+
+public:
+
+    // Holds at most maxEntries frames. The database must outlive the cache
+    explicit DecodeCache(const DbcParser& dbcFile, size_t maxEntries = 4096, unsigned int shardCount = 16);
+    // Same as DbcParser::tryDecodeSignals(). The visitor runs while the shard is locked,
+    // so it must not use the same cache
+    template <typename SignalVisitor>
+    CodecStatus tryDecodeSignals(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        SignalVisitor&& visitor
+    ) {
+        if (msgSize > MAX_MSG_LEN_CAN_FD) {
+            return dbcFile->tryDecodeSignals(msgId, msgSize, payload, std::forward<SignalVisitor>(visitor));
+        }
+        uint64_t hash = hashFrame(msgId, msgSize, payload);
+        Shard& shard = shards[(hash >> 32) & shardMask];
+        std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            bypasses.fetch_add(1, std::memory_order_relaxed);
+            return dbcFile->tryDecodeSignals(msgId, msgSize, payload, std::forward<SignalVisitor>(visitor));
+        }
+        // Hits count as decoded frames in the metrics of the database, with their latency,
+        // so the metrics do not depend on the hit rate
+        LatencyTimer timer(*dbcFile->metrics, MetricsOperation::Decode);
+        Entry* entry = find(shard, hash, msgId, msgSize, payload);
+        if (entry != nullptr) {
+            shard.hits++;
+            for (auto& value : entry->values) {
+                visitor(*value.first, value.second);
+            }
+            dbcFile->metrics->countDecoded(entry->messageIndex);
+            return CodecStatus::Ok;
+        }
+        shard.misses++;
+        DBC_TRACE_SCOPE("decode");
+        const Message* message = dbcFile->findMessage(msgId, dbcFile->isJ1939Mode());
+        if (message == nullptr || msgSize != message->getDlc()) {
+            // Never cached, so unknown IDs and wrong sizes do not evict frames that decode
+            return dbcFile->tryDecodeMessage(message, msgSize, payload, std::forward<SignalVisitor>(visitor));
+        }
+        // The entry only becomes valid once the whole frame decoded
+        entry = &replace(shard, hash, msgId, msgSize, payload);
+        CodecStatus status = dbcFile->tryDecodeMessage(message, msgSize, payload,
+            [entry, &visitor](const Signal& sig, double value) {
+                entry->values.emplace_back(&sig, value);
+                visitor(sig, value);
+            });
+        if (status == CodecStatus::Ok) {
+            entry->messageIndex = message->getIndex();
+            entry->isValid = true;
+            shard.entryCount++;
+        }
+        return status;
+    }
+    // Same as DbcParser::tryDecode()
+    CodecStatus tryDecode(
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[],
+        std::unordered_map<std::string, double>& result
+    );
+    DecodeCacheStatistics getStatistics() const;
+    void resetStatistics();
+    // Forget all frames, e.g. after the meaning of the payloads changed
+    void clear();
+
+private:
+
+    struct Entry {
+        uint64_t hash = 0;
+        uint64_t lastUse = 0;
+        unsigned long msgId = 0;
+        unsigned int msgSize = 0;
+        // Message the frame was decoded with, for the runtime metrics
+        unsigned int messageIndex = 0;
+        bool isValid = false;
+        std::array<unsigned char, MAX_MSG_LEN_CAN_FD> payload{};
+        // Decoded signals in the order of the visitor calls
+        std::vector<std::pair<const Signal*, double> > values;
+    };
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        // setCount sets of DECODE_CACHE_WAYS entries
+        std::vector<Entry> entries;
+        uint64_t useCounter = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entryCount = 0;
+    };
+    const DbcParser* dbcFile;
+    std::unique_ptr<Shard[]> shards;
+    uint64_t shardMask = 0;
+    uint64_t setMask = 0;
+    std::atomic<uint64_t> bypasses{};
+
+    static uint64_t hashFrame(unsigned long msgId, unsigned int msgSize, unsigned char const payload[]);
+    Entry* find(Shard& shard, uint64_t hash, unsigned long msgId, unsigned int msgSize,
+        unsigned char const payload[]);
+    // Clears the least recently used entry of the set and fills in the key
+    Entry& replace(Shard& shard, uint64_t hash, unsigned long msgId, unsigned int msgSize,
+        unsigned char const payload[]);
+
+};
+
+#endif
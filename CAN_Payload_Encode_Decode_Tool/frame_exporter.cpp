@@ -0,0 +1,104 @@
+/*
+ *  frame_exporter.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include "frame_exporter.hpp"
+
+namespace {
+
+    // Units may contain commas or quotes, which CSV only allows inside quotes
+    void appendCsvField(OutputBuffer& output, std::string_view text) {
+        if (text.find_first_of(",\"\n") == std::string_view::npos) {
+            output.append(text);
+            return;
+        }
+        output.append('"');
+        for (char c : text) {
+            if (c == '"') {
+                output.append('"');
+            }
+            output.append(c);
+        }
+        output.append('"');
+    }
+
+}
+
+void FrameExporter::writeHeader() {
+    if (format == ExportFormat::Csv) {
+        output->append("timestamp,channel,id,signal,value,unit\n");
+    }
+}
+
+void FrameExporter::exportSignal(const CanFrame& frame, const Signal& sig, double value) {
+    char separator = format == ExportFormat::Csv ? ',' : ' ';
+    output->appendTimestamp(frame.timestamp);
+    output->append(separator);
+    output->appendNumber(frame.channel);
+    output->append(separator);
+    output->appendNumber(frame.id);
+    output->append(separator);
+    output->append(sig.getNameView());
+    output->append(separator);
+    output->appendNumber(value);
+    if (format == ExportFormat::Csv) {
+        output->append(separator);
+        appendCsvField(*output, sig.getUnitView());
+    }
+    else if (!sig.getUnitView().empty()) {
+        output->append(separator);
+        output->append(sig.getUnitView());
+    }
+    output->append('\n');
+}
+
+CodecStatus FrameExporter::exportFrame(const CanFrame& frame) {
+    // Contains the "decode" span, the rest of it is formatting
+    DBC_TRACE_SCOPE("export");
+    if (format != ExportFormat::JsonLines) {
+        return dbcFile->tryDecodeSignals(frame.id, frame.size, frame.payload,
+            [this, &frame](const Signal& sig, double value) {
+                exportSignal(frame, sig, value);
+            });
+    }
+    // The frame is only opened at its first signal, so frames that do not decode leave nothing behind
+    bool isOpen = false;
+    auto open = [this, &frame, &isOpen]() {
+        output->append("{\"timestamp\":");
+        output->appendTimestamp(frame.timestamp);
+        output->append(",\"channel\":");
+        output->appendNumber(frame.channel);
+        output->append(",\"id\":");
+        output->appendNumber(frame.id);
+        output->append(",\"signals\":{");
+        isOpen = true;
+    };
+    CodecStatus status = dbcFile->tryDecodeSignals(frame.id, frame.size, frame.payload,
+        [this, &isOpen, &open](const Signal& sig, double value) {
+            if (isOpen) {
+                output->append(',');
+            }
+            else {
+                open();
+            }
+            output->appendJsonString(sig.getNameView());
+            output->append(':');
+            // JSON has no NaN or infinity
+            if (value - value == 0) {
+                output->appendNumber(value);
+            }
+            else {
+                output->append("null");
+            }
+        });
+    if (status == CodecStatus::Ok) {
+        if (!isOpen) {
+            open();
+        }
+        output->append("}}\n");
+    }
+    return status;
+}
@@ -0,0 +1,48 @@
+/*
+ *  frame_exporter.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef FRAME_EXPORTER_HPP
+#define FRAME_EXPORTER_HPP
+
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+#include "dbc_parser_dependencies/output_buffer.hpp"
+
+enum class ExportFormat {
+    // 1436509052.249713 1 258 EngSpeed 1000 rpm
+    Text,
+    // timestamp,channel,id,signal,value,unit
+    Csv,
+    // One JSON object per frame, e.g.
+    // {"timestamp":1436509052.249713,"channel":1,"id":258,"signals":{"EngSpeed":1000}}
+    JsonLines
+};
+
+// Writes decoded frames as text, CSV or JSON lines into an OutputBuffer
+// Text and CSV have one line per signal, JSON lines one line per frame
+class FrameExporter {
+
+public:
+
+    FrameExporter(const DbcParser& dbcFile, OutputBuffer& output, ExportFormat format) :
+        dbcFile(&dbcFile), output(&output), format(format) {}
+    // The CSV column names. Nothing for the other formats
+    void writeHeader();
+    // Decode a frame and write its signals. Frames that do not decode are skipped
+    CodecStatus exportFrame(const CanFrame& frame);
+    // Write one signal that was decoded elsewhere. Only for text and CSV
+    void exportSignal(const CanFrame& frame, const Signal& sig, double value);
+
+private:
+
+    const DbcParser* dbcFile;
+    OutputBuffer* output;
+    ExportFormat format;
+
+};
+
+#endif
@@ -0,0 +1,296 @@
+/*
+ *  frame_filter.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+#include <stdexcept>
+#include "frame_filter.hpp"
+
+namespace {
+
+    struct Token {
+        std::string text;
+        bool isQuoted = false;
+    };
+
+    // Split the expression into names, values, quoted labels and operators
+    std::vector<Token> tokenize(const std::string& expression) {
+        std::vector<Token> tokens;
+        const std::string operatorChars = "&|=!<>";
+        size_t pos = 0;
+        while (pos < expression.size()) {
+            char c = expression[pos];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                pos++;
+            }
+            else if (c == '\"') {
+                size_t end = expression.find('\"', pos + 1);
+                if (end == std::string::npos) {
+                    throw std::invalid_argument("Filter compile failed. Missing closing quote in expression.");
+                }
+                tokens.push_back({ expression.substr(pos + 1, end - pos - 1), true });
+                pos = end + 1;
+            }
+            else if (operatorChars.find(c) != std::string::npos) {
+                size_t end = pos;
+                while (end < expression.size() && operatorChars.find(expression[end]) != std::string::npos) {
+                    end++;
+                }
+                tokens.push_back({ expression.substr(pos, end - pos), false });
+                pos = end;
+            }
+            else {
+                size_t end = pos;
+                while (end < expression.size()
+                    && !std::isspace(static_cast<unsigned char>(expression[end]))
+                    && operatorChars.find(expression[end]) == std::string::npos
+                    && expression[end] != '\"') {
+                    end++;
+                }
+                tokens.push_back({ expression.substr(pos, end - pos), false });
+                pos = end;
+            }
+        }
+        return tokens;
+    }
+
+    // Find a signal by "SignalName" or "MessageName.SignalName"
+    SignalHandle resolveSignal(const DbcParser& dbcFile, const std::string& qualifiedName) {
+        std::string msgName;
+        std::string sigName = qualifiedName;
+        size_t dotPos = qualifiedName.find('.');
+        if (dotPos != std::string::npos) {
+            msgName = qualifiedName.substr(0, dotPos);
+            sigName = qualifiedName.substr(dotPos + 1);
+        }
+        SignalHandle found = 0;
+        unsigned int matchCount = 0;
+        for (SignalHandle handle : dbcFile.findSignals(sigName)) {
+            if (msgName.empty() || dbcFile.getMessageOfSignal(handle)->getName() == msgName) {
+                found = handle;
+                matchCount++;
+            }
+        }
+        if (matchCount == 0) {
+            throw std::invalid_argument("Filter compile failed. Cannot find signal: "
+                + qualifiedName + " in CAN database.");
+        }
+        if (matchCount > 1) {
+            throw std::invalid_argument("Filter compile failed. Signal name \"" + qualifiedName
+                + "\" is ambiguous, qualify it with its message name.");
+        }
+        return found;
+    }
+
+}
+
+FrameFilter::FrameFilter(const DbcParser& dbcFile, const std::string& expression) {
+    std::vector<Token> tokens = tokenize(expression);
+    if (tokens.empty()) {
+        throw std::invalid_argument("Filter compile failed. Empty expression.");
+    }
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+        // Parse one && chain
+        Conjunction conjunction;
+        const Message* conjunctionMessage = nullptr;
+        bool canMatch = true;
+        while (true) {
+            if (pos + 3 > tokens.size() || tokens[pos].isQuoted) {
+                throw std::invalid_argument("Filter compile failed. "
+                    "Expected \"<signal> <operator> <value>\" in expression.");
+            }
+            SignalHandle handle = resolveSignal(dbcFile, tokens[pos].text);
+            const Signal& sig = *dbcFile.getSignal(handle);
+            const Message* msg = dbcFile.getMessageOfSignal(handle);
+            // Read the comparison operator
+            const std::string& opText = tokens[pos + 1].text;
+            ComparisonOp op;
+            if (opText == "==") { op = ComparisonOp::Equal; }
+            else if (opText == "!=") { op = ComparisonOp::NotEqual; }
+            else if (opText == "<") { op = ComparisonOp::Less; }
+            else if (opText == "<=") { op = ComparisonOp::LessEqual; }
+            else if (opText == ">") { op = ComparisonOp::Greater; }
+            else if (opText == ">=") { op = ComparisonOp::GreaterEqual; }
+            else {
+                throw std::invalid_argument("Filter compile failed. Unknown operator \"" + opText + "\".");
+            }
+            // Read the value, either a number or a value description label
+            const Token& valueToken = tokens[pos + 2];
+            double physicalValue = 0;
+            if (valueToken.isQuoted) {
+                bool labelFound = false;
+                for (auto& description : sig.getValueDescriptions()) {
+                    if (std::string_view(description.second) == valueToken.text) {
+                        // Value descriptions are defined on raw values
+                        physicalValue = description.first * sig.getFactor() + sig.getOffset();
+                        labelFound = true;
+                        break;
+                    }
+                }
+                if (!labelFound) {
+                    throw std::invalid_argument("Filter compile failed. Signal \"" + sig.getName()
+                        + "\" has no value description \"" + valueToken.text + "\".");
+                }
+            }
+            else {
+                try {
+                    physicalValue = std::stod(valueToken.text);
+                }
+                catch (std::exception&) {
+                    throw std::invalid_argument("Filter compile failed. \"" + valueToken.text
+                        + "\" is not a number.");
+                }
+            }
+            // Conditions on two different messages can never hold for the same frame
+            if (conjunctionMessage != nullptr && conjunctionMessage != msg) {
+                canMatch = false;
+            }
+            conjunctionMessage = msg;
+            conjunction.push_back(compileCondition(sig, op, physicalValue));
+            pos += 3;
+            if (pos < tokens.size() && tokens[pos].text == "&&" && !tokens[pos].isQuoted) {
+                pos++;
+                continue;
+            }
+            break;
+        }
+        if (canMatch) {
+            MessageFilter& messageFilter = messageFilters[conjunctionMessage->getId()];
+            messageFilter.dlc = conjunctionMessage->getDlc();
+            messageFilter.conjunctions.push_back(conjunction);
+        }
+        if (pos < tokens.size()) {
+            if (tokens[pos].text != "||" || tokens[pos].isQuoted || pos + 1 == tokens.size()) {
+                throw std::invalid_argument("Filter compile failed. Unexpected \""
+                    + tokens[pos].text + "\" in expression.");
+            }
+            pos++;
+        }
+    }
+}
+
+FrameFilter::Condition FrameFilter::compileCondition(const Signal& sig, ComparisonOp op, double physicalValue) {
+    Condition condition;
+    condition.signal = &sig;
+    condition.op = op;
+    condition.threshold = physicalValue;
+    bool isInteger = sig.getValueTypes() == ValueType::Signed || sig.getValueTypes() == ValueType::Unsigned;
+    if (!isInteger || sig.getSignalSize() >= 64 || sig.getFactor() == 0) {
+        condition.isRawRange = false;
+        return condition;
+    }
+    // physical = raw * factor + offset, so solve for raw
+    double rawThreshold = (physicalValue - sig.getOffset()) / sig.getFactor();
+    // Absorb rounding noise of the division so that e.g. 0.3 / 0.1 is treated as 3
+    double nearest = std::round(rawThreshold);
+    if (std::fabs(rawThreshold - nearest) <= 1e-9 * std::max(1.0, std::fabs(nearest))) {
+        rawThreshold = nearest;
+    }
+    // A negative factor reverses the ordering
+    if (sig.getFactor() < 0) {
+        if (op == ComparisonOp::Less) { op = ComparisonOp::Greater; }
+        else if (op == ComparisonOp::LessEqual) { op = ComparisonOp::GreaterEqual; }
+        else if (op == ComparisonOp::Greater) { op = ComparisonOp::Less; }
+        else if (op == ComparisonOp::GreaterEqual) { op = ComparisonOp::LessEqual; }
+    }
+    // Range of values the raw bits can hold
+    unsigned int size = sig.getSignalSize();
+    double rawMin = 0;
+    double rawMax = std::ldexp(1.0, size) - 1;
+    if (sig.getValueTypes() == ValueType::Signed) {
+        rawMin = -std::ldexp(1.0, size - 1);
+        rawMax = std::ldexp(1.0, size - 1) - 1;
+    }
+    double lower = rawMin;
+    double upper = rawMax;
+    switch (op) {
+    case ComparisonOp::NotEqual:
+        condition.negate = true;
+        [[fallthrough]];
+    case ComparisonOp::Equal:
+        if (rawThreshold != std::floor(rawThreshold)) {
+            // Not reachable by any raw value
+            lower = 1;
+            upper = 0;
+        }
+        else {
+            lower = rawThreshold;
+            upper = rawThreshold;
+        }
+        break;
+    case ComparisonOp::Less:
+        upper = std::ceil(rawThreshold) - 1;
+        break;
+    case ComparisonOp::LessEqual:
+        upper = std::floor(rawThreshold);
+        break;
+    case ComparisonOp::Greater:
+        lower = std::floor(rawThreshold) + 1;
+        break;
+    case ComparisonOp::GreaterEqual:
+        lower = std::ceil(rawThreshold);
+        break;
+    }
+    lower = std::max(lower, rawMin);
+    upper = std::min(upper, rawMax);
+    if (lower > upper) {
+        condition.lowerBound = 1;
+        condition.upperBound = 0;
+    }
+    else {
+        condition.lowerBound = static_cast<int64_t>(lower);
+        condition.upperBound = static_cast<int64_t>(upper);
+    }
+    return condition;
+}
+
+bool FrameFilter::evaluate(const Condition& condition, unsigned char const payload[]) {
+    const Signal& sig = *condition.signal;
+    uint64_t rawValue = sig.extractRawValue(payload);
+    if (!condition.isRawRange) {
+        double value = sig.rawToPhysical(rawValue);
+        switch (condition.op) {
+        case ComparisonOp::Equal: return value == condition.threshold;
+        case ComparisonOp::NotEqual: return value != condition.threshold;
+        case ComparisonOp::Less: return value < condition.threshold;
+        case ComparisonOp::LessEqual: return value <= condition.threshold;
+        case ComparisonOp::Greater: return value > condition.threshold;
+        case ComparisonOp::GreaterEqual: return value >= condition.threshold;
+        }
+        return false;
+    }
+    // Sign extend for signed signal values
+    unsigned int size = sig.getSignalSize();
+    if (sig.getValueTypes() == ValueType::Signed && (rawValue & (1ULL << (size - 1)))) {
+        rawValue |= ~((1ULL << size) - 1);
+    }
+    int64_t value = static_cast<int64_t>(rawValue);
+    bool inRange = condition.lowerBound <= value && value <= condition.upperBound;
+    return inRange != condition.negate;
+}
+
+bool FrameFilter::matches(unsigned long msgId, unsigned int msgSize, unsigned char const payload[]) const {
+    auto filter_itr = messageFilters.find(msgId);
+    if (filter_itr == messageFilters.end() || msgSize != filter_itr->second.dlc) {
+        return false;
+    }
+    for (auto& conjunction : filter_itr->second.conjunctions) {
+        bool allHold = true;
+        for (auto& condition : conjunction) {
+            if (!evaluate(condition, payload)) {
+                allHold = false;
+                break;
+            }
+        }
+        if (allHold) {
+            return true;
+        }
+    }
+    return false;
+}
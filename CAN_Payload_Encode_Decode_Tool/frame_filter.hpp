@@ -0,0 +1,69 @@
+/*
+ *  frame_filter.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef FRAME_FILTER_HPP
+#define FRAME_FILTER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+
+// A filter expression compiled against a CAN database, e.g.
+//     EngSpeed > 3000 && Gear == "Second" || EngineData.EngTemp >= 90
+// Conditions compare a signal with a physical value (or a VAL_ label) using
+// ==, !=, <, <=, > or >=. && binds tighter than ||. Signal names can be qualified
+// with their message name when the same name exists in several messages.
+// Thresholds are converted into raw integer ranges once, so testing a frame only
+// extracts the raw bits of the referenced signals and compares them. Frames of
+// messages that are not referenced by the expression never match.
+class FrameFilter {
+
+public:
+
+    FrameFilter(const DbcParser& dbcFile, const std::string& expression);
+    // Check a frame before decoding it
+    bool matches(unsigned long msgId, unsigned int msgSize, unsigned char const payload[]) const;
+
+private:
+
+    enum class ComparisonOp {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+    // A single comparison on one signal
+    struct Condition {
+        const Signal* signal = nullptr;
+        // Integer signals: the condition holds when lowerBound <= raw <= upperBound, inverted if negate is set
+        bool isRawRange = true;
+        bool negate = false;
+        int64_t lowerBound = 0;
+        int64_t upperBound = 0;
+        // IEEE float and 64-bit unsigned signals fall back to comparing physical values
+        ComparisonOp op = ComparisonOp::Equal;
+        double threshold = 0;
+    };
+    // All conditions of one && chain, they always refer to the same message
+    typedef std::vector<Condition> Conjunction;
+    struct MessageFilter {
+        unsigned int dlc = 0;
+        std::vector<Conjunction> conjunctions;
+    };
+    // <Message id, || chains that can match frames of this message>
+    std::unordered_map<unsigned long, MessageFilter> messageFilters;
+
+    static bool evaluate(const Condition& condition, unsigned char const payload[]);
+    static Condition compileCondition(const Signal& sig, ComparisonOp op, double physicalValue);
+
+};
+
+#endif
@@ -0,0 +1,389 @@
+/*
+ *  frame_scheduler.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <bit>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "frame_scheduler.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <linux/can/raw.h>
+#endif
+
+namespace {
+
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    void appendHex(std::string& out, uint64_t value, unsigned int digits) {
+        for (unsigned int i = digits; i > 0; i--) {
+            out.push_back(HEX_DIGITS[(value >> ((i - 1) * 4)) & 0xF]);
+        }
+    }
+
+    void appendDecimal(std::string& out, uint64_t value, unsigned int minDigits) {
+        char digits[20];
+        unsigned int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        for (; count < minDigits; count++) {
+            digits[count] = '0';
+        }
+        while (count > 0) {
+            out.push_back(digits[--count]);
+        }
+    }
+
+    uint64_t toTicks(uint64_t milliseconds, uint64_t tickMicroseconds) {
+        return (milliseconds * 1000 + tickMicroseconds / 2) / tickMicroseconds;
+    }
+
+}
+
+CandumpFileSink::CandumpFileSink(const std::string& logPath, const std::string& interfaceName) :
+    interfaceName(interfaceName) {
+    file = std::fopen(logPath.c_str(), "w");
+    if (file == nullptr) {
+        throw std::invalid_argument("Could not open log file \"" + logPath + "\".");
+    }
+}
+
+CandumpFileSink::~CandumpFileSink() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+}
+
+void CandumpFileSink::send(const CanFrame frames[], size_t count) {
+    lineBuffer.clear();
+    for (size_t i = 0; i < count; i++) {
+        const CanFrame& frame = frames[i];
+        // (1436509052.249713) can0 18FEF100#0102030405060708
+        lineBuffer.push_back('(');
+        appendDecimal(lineBuffer, frame.timestamp / 1000000, 1);
+        lineBuffer.push_back('.');
+        appendDecimal(lineBuffer, frame.timestamp % 1000000, 6);
+        lineBuffer.append(") ");
+        lineBuffer.append(interfaceName);
+        lineBuffer.push_back(' ');
+        if (frame.id & CAN_ID_EXTENDED_FLAG) {
+            appendHex(lineBuffer, frame.id & ~CAN_ID_EXTENDED_FLAG, 8);
+        }
+        else {
+            appendHex(lineBuffer, frame.id, 3);
+        }
+        lineBuffer.push_back('#');
+        // CAN FD frames have a second '#' followed by the flags
+        if (frame.size > MAX_MSG_LEN_CAN) {
+            lineBuffer.append("#0");
+        }
+        for (unsigned int b = 0; b < frame.size; b++) {
+            appendHex(lineBuffer, frame.payload[b], 2);
+        }
+        lineBuffer.push_back('\n');
+    }
+    std::fwrite(lineBuffer.data(), 1, lineBuffer.size(), file);
+}
+
+void CandumpFileSink::flush() {
+    std::fflush(file);
+}
+
+#ifdef __linux__
+
+SocketCanSink::SocketCanSink(const std::string& interfaceName) {
+    socketFd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (socketFd < 0) {
+        throw std::invalid_argument(std::string("Could not open CAN socket: ") + std::strerror(errno));
+    }
+    int enable = 1;
+    // CAN FD frames cannot be sent without CAN_RAW_FD_FRAMES. Only sends, so nothing is queued for receiving
+    if (setsockopt(socketFd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0
+        || setsockopt(socketFd, SOL_CAN_RAW, CAN_RAW_FILTER, nullptr, 0) < 0) {
+        std::string error = std::string("Could not configure CAN socket: ") + std::strerror(errno);
+        close(socketFd);
+        throw std::invalid_argument(error);
+    }
+    ifreq interfaceRequest{};
+    std::strncpy(interfaceRequest.ifr_name, interfaceName.c_str(), IFNAMSIZ - 1);
+    sockaddr_can address{};
+    address.can_family = AF_CAN;
+    if (ioctl(socketFd, SIOCGIFINDEX, &interfaceRequest) < 0
+        || (address.can_ifindex = interfaceRequest.ifr_ifindex,
+            bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)) {
+        std::string error = "Could not bind to CAN interface \"" + interfaceName + "\": " + std::strerror(errno);
+        close(socketFd);
+        throw std::invalid_argument(error);
+    }
+}
+
+SocketCanSink::~SocketCanSink() {
+    if (socketFd >= 0) {
+        close(socketFd);
+    }
+}
+
+void SocketCanSink::send(const CanFrame frames[], size_t count) {
+    if (rawFrames.size() < count) {
+        rawFrames.resize(count);
+        ioVectors.resize(count);
+        messages.resize(count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        const CanFrame& frame = frames[i];
+        canfd_frame& raw = rawFrames[i];
+        raw = canfd_frame();
+        raw.can_id = (frame.id & CAN_ID_EXTENDED_FLAG)
+            ? (static_cast<canid_t>(frame.id) & CAN_EFF_MASK) | CAN_EFF_FLAG
+            : static_cast<canid_t>(frame.id) & CAN_SFF_MASK;
+        raw.len = static_cast<__u8>(std::min<unsigned int>(frame.size, CANFD_MAX_DLEN));
+        std::memcpy(raw.data, frame.payload, raw.len);
+        ioVectors[i].iov_base = &raw;
+        ioVectors[i].iov_len = frame.size > MAX_MSG_LEN_CAN ? CANFD_MTU : CAN_MTU;
+        messages[i] = mmsghdr();
+        messages[i].msg_hdr.msg_iov = &ioVectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    size_t sent = 0;
+    while (sent < count) {
+        int result = sendmmsg(socketFd, messages.data() + sent, static_cast<unsigned int>(count - sent), 0);
+        if (result <= 0) {
+            // CAN drivers report a full transmit queue with ENOBUFS instead of blocking
+            droppedCount += count - sent;
+            break;
+        }
+        sent += static_cast<size_t>(result);
+    }
+}
+
+#endif /* __linux__ */
+
+FrameScheduler::FrameScheduler(const DbcParser& dbcFile, FrameSink& sink, uint64_t tickMicroseconds,
+    size_t batchSize) : dbcFile(&dbcFile), sink(&sink), tickMicroseconds(tickMicroseconds), batchSize(batchSize) {
+    if (tickMicroseconds == 0 || batchSize == 0) {
+        throw std::invalid_argument("Scheduler failed. Tick and batch size must be positive.");
+    }
+    for (auto& level : wheel) {
+        level.fill(NO_MESSAGE);
+    }
+    batch.reserve(batchSize);
+}
+
+void FrameScheduler::addMessage(unsigned long msgId, unsigned int cycleTimeMs, unsigned int phaseMs) {
+    if (cycleTimeMs == 0) {
+        throw std::invalid_argument("Scheduler failed. Cycle time of message (ID: "
+            + std::to_string(msgId) + ") must be positive.");
+    }
+    if (messageIndex.count(msgId)) {
+        throw std::invalid_argument("Scheduler failed. Message (ID: "
+            + std::to_string(msgId) + ") is already scheduled.");
+    }
+    ScheduledMessage message;
+    message.frame.id = msgId;
+    // Encoding without values gives every signal its initial value
+    CodecStatus status = dbcFile->tryEncode(msgId, std::vector<std::pair<std::string, double> >(),
+        message.frame.payload, MAX_MSG_LEN_CAN_FD, message.frame.size);
+    if (status != CodecStatus::Ok && status != CodecStatus::ValueOutOfRange) {
+        throw std::invalid_argument("Scheduler failed. Cannot encode message (ID: "
+            + std::to_string(msgId) + "): " + toString(status) + ".");
+    }
+    // Periods beyond the reach of the wheel are cut to its range
+    message.periodTicks = std::clamp<uint64_t>(toTicks(cycleTimeMs, tickMicroseconds), 1,
+        (1ULL << (WHEEL_LEVEL_COUNT * WHEEL_LEVEL_BITS)) - 1);
+    message.phaseTicks = std::min(toTicks(phaseMs, tickMicroseconds), message.periodTicks - 1);
+    uint32_t index = static_cast<uint32_t>(messages.size());
+    messages.push_back(message);
+    messageIndex.emplace(msgId, index);
+    if (isStarted) {
+        messages[index].deadlineTick = currentTick + message.phaseTicks;
+        insert(index);
+    }
+}
+
+void FrameScheduler::addCyclicMessages() {
+    std::vector<std::pair<unsigned long, unsigned int> > cyclicMessages = dbcFile->getCyclicMessages();
+    for (size_t i = 0; i < cyclicMessages.size(); i++) {
+        if (messageIndex.count(cyclicMessages[i].first) == 0 && cyclicMessages[i].second != 0) {
+            addMessage(cyclicMessages[i].first, cyclicMessages[i].second,
+                static_cast<unsigned int>(i % cyclicMessages[i].second));
+        }
+    }
+}
+
+CodecStatus FrameScheduler::setSignalValue(SignalHandle handle, double physicalValue) {
+    const Signal* sig = dbcFile->getSignal(handle);
+    if (sig == nullptr) {
+        return CodecStatus::UnknownSignal;
+    }
+    auto index_itr = messageIndex.find(dbcFile->getMessageOfSignal(handle)->getId());
+    if (index_itr == messageIndex.end()) {
+        return CodecStatus::UnknownMessage;
+    }
+    if (!sig->isInRange(physicalValue)) {
+        return CodecStatus::ValueOutOfRange;
+    }
+    // Only the bits of this signal are replaced, the rest of the frame stays as it is
+    sig->encodeSignal(physicalValue, messages[index_itr->second].frame.payload, MAX_MSG_LEN_CAN_FD);
+    return CodecStatus::Ok;
+}
+
+CodecStatus FrameScheduler::setSignalValues(unsigned long msgId,
+    const std::vector<std::pair<std::string, double> >& signalValues) {
+    if (messageIndex.count(msgId) == 0) {
+        return CodecStatus::UnknownMessage;
+    }
+    // Check all names first, so an unknown signal leaves the frame untouched
+    std::vector<SignalHandle> handles;
+    handles.reserve(signalValues.size());
+    for (auto& signalValue : signalValues) {
+        std::optional<SignalHandle> handle = dbcFile->getSignalHandle(msgId, signalValue.first);
+        if (!handle.has_value()) {
+            return CodecStatus::UnknownSignal;
+        }
+        handles.push_back(*handle);
+    }
+    CodecStatus result = CodecStatus::Ok;
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (setSignalValue(handles[i], signalValues[i].second) != CodecStatus::Ok) {
+            result = CodecStatus::ValueOutOfRange;
+        }
+    }
+    return result;
+}
+
+void FrameScheduler::setActive(unsigned long msgId, bool isActive) {
+    auto index_itr = messageIndex.find(msgId);
+    if (index_itr == messageIndex.end()) {
+        throw std::invalid_argument("Scheduler failed. Message (ID: "
+            + std::to_string(msgId) + ") is not scheduled.");
+    }
+    // Inactive messages stay on the wheel, so they keep their phase
+    messages[index_itr->second].isActive = isActive;
+}
+
+void FrameScheduler::start(uint64_t now) {
+    if (isStarted) {
+        return;
+    }
+    currentTick = now / tickMicroseconds;
+    isStarted = true;
+    for (uint32_t index = 0; index < messages.size(); index++) {
+        messages[index].deadlineTick = currentTick + messages[index].phaseTicks;
+        insert(index);
+    }
+}
+
+void FrameScheduler::insert(uint32_t index) {
+    ScheduledMessage& message = messages[index];
+    uint64_t delta = message.deadlineTick - currentTick;
+    unsigned int level = 0;
+    while (level + 1 < WHEEL_LEVEL_COUNT && delta >= (1ULL << ((level + 1) * WHEEL_LEVEL_BITS))) {
+        level++;
+    }
+    uint32_t& slot = wheel[level][(message.deadlineTick >> (level * WHEEL_LEVEL_BITS)) & (WHEEL_SLOT_COUNT - 1)];
+    message.next = slot;
+    slot = index;
+}
+
+unsigned int FrameScheduler::cascade(unsigned int level) {
+    unsigned int slotIndex = (currentTick >> (level * WHEEL_LEVEL_BITS)) & (WHEEL_SLOT_COUNT - 1);
+    uint32_t index = wheel[level][slotIndex];
+    wheel[level][slotIndex] = NO_MESSAGE;
+    // Everything in this slot is due within the next window of the level below
+    while (index != NO_MESSAGE) {
+        uint32_t next = messages[index].next;
+        insert(index);
+        index = next;
+    }
+    return slotIndex;
+}
+
+void FrameScheduler::advance(uint64_t now) {
+    start(now);
+    uint64_t nowTick = now / tickMicroseconds;
+    while (currentTick <= nowTick) {
+        // At the start of every window of a level, the matching slot of the level above moves down
+        if ((currentTick & (WHEEL_SLOT_COUNT - 1)) == 0) {
+            for (unsigned int level = 1; level < WHEEL_LEVEL_COUNT && cascade(level) == 0; level++) {}
+        }
+        uint32_t& slot = wheel[0][currentTick & (WHEEL_SLOT_COUNT - 1)];
+        uint32_t index = slot;
+        slot = NO_MESSAGE;
+        while (index != NO_MESSAGE) {
+            ScheduledMessage& message = messages[index];
+            uint32_t next = message.next;
+            emit(message, now);
+            message.deadlineTick += message.periodTicks;
+            if (message.deadlineTick <= nowTick) {
+                uint64_t missed = (nowTick - message.deadlineTick) / message.periodTicks + 1;
+                if (message.isActive) {
+                    statistics.skippedFrames += missed;
+                }
+                message.deadlineTick += missed * message.periodTicks;
+            }
+            insert(index);
+            index = next;
+        }
+        currentTick++;
+    }
+    flushBatch();
+}
+
+void FrameScheduler::emit(ScheduledMessage& message, uint64_t now) {
+    if (!message.isActive) {
+        return;
+    }
+    batch.push_back(message.frame);
+    batch.back().timestamp = now;
+    uint64_t lateness = now - message.deadlineTick * tickMicroseconds;
+    statistics.framesSent++;
+    statistics.totalLateness += lateness;
+    statistics.maxLateness = std::max(statistics.maxLateness, lateness);
+    statistics.latenessHistogram[std::min<unsigned int>(std::bit_width(lateness), LATENESS_BUCKET_COUNT - 1)]++;
+    if (batch.size() == batchSize) {
+        flushBatch();
+    }
+}
+
+void FrameScheduler::flushBatch() {
+    if (!batch.empty()) {
+        sink->send(batch.data(), batch.size());
+        statistics.batches++;
+        batch.clear();
+    }
+}
+
+void FrameScheduler::run(uint64_t durationMicroseconds) {
+    auto toMicroseconds = [](auto duration) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+    // Frames get Unix time stamps, as candump logs have, but the time runs on the steady clock
+    // so adjustments of the system clock do not disturb the deadlines
+    uint64_t steadyStart = toMicroseconds(std::chrono::steady_clock::now().time_since_epoch());
+    uint64_t systemStart = toMicroseconds(std::chrono::system_clock::now().time_since_epoch());
+    uint64_t end = systemStart + durationMicroseconds;
+    while (!isStopRequested.load(std::memory_order_relaxed)) {
+        uint64_t now = systemStart + (toMicroseconds(std::chrono::steady_clock::now().time_since_epoch()) - steadyStart);
+        if (now >= end) {
+            break;
+        }
+        advance(now);
+        // Sleep until the next tick begins
+        uint64_t wakeUp = std::min(end, (now / tickMicroseconds + 1) * tickMicroseconds);
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::microseconds(steadyStart + (wakeUp - systemStart))));
+    }
+    isStopRequested.store(false, std::memory_order_relaxed);
+}
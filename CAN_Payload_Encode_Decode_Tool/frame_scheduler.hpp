@@ -0,0 +1,176 @@
+/*
+ *  frame_scheduler.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef FRAME_SCHEDULER_HPP
+#define FRAME_SCHEDULER_HPP
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+#ifdef __linux__
+#include <linux/can.h>
+#include <sys/socket.h>
+#endif
+
+// Lateness bucket i holds frames sent [2^(i-1), 2^i) microseconds after their deadline,
+// the last bucket is open ended
+constexpr unsigned int LATENESS_BUCKET_COUNT = 24;
+// The timer wheel has 4 levels of 256 slots, so deadlines up to 2^32 ticks ahead are exact
+constexpr unsigned int WHEEL_LEVEL_COUNT = 4;
+constexpr unsigned int WHEEL_LEVEL_BITS = 8;
+
+// Receives the frames that are due, one batch per call
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+    virtual void send(const CanFrame frames[], size_t count) = 0;
+};
+
+class CallbackFrameSink : public FrameSink {
+public:
+    typedef std::function<void(const CanFrame frames[], size_t count)> Callback;
+    explicit CallbackFrameSink(Callback callback) : callback(std::move(callback)) {}
+    void send(const CanFrame frames[], size_t count) override { callback(frames, count); }
+private:
+    Callback callback;
+};
+
+// Writes the frames as a candump log (candump -l), which CanLogReader can read back
+class CandumpFileSink : public FrameSink {
+public:
+    explicit CandumpFileSink(const std::string& logPath, const std::string& interfaceName = "can0");
+    ~CandumpFileSink();
+    CandumpFileSink(const CandumpFileSink&) = delete;
+    CandumpFileSink& operator=(const CandumpFileSink&) = delete;
+    void send(const CanFrame frames[], size_t count) override;
+    void flush();
+private:
+    FILE* file = nullptr;
+    std::string interfaceName;
+    // Lines of one batch are formatted here and written at once
+    std::string lineBuffer;
+};
+
+#ifdef __linux__
+// Sends the frames on a raw SocketCAN socket (e.g. "can0" or "vcan0"), one system call per batch
+class SocketCanSink : public FrameSink {
+public:
+    explicit SocketCanSink(const std::string& interfaceName);
+    ~SocketCanSink();
+    SocketCanSink(const SocketCanSink&) = delete;
+    SocketCanSink& operator=(const SocketCanSink&) = delete;
+    void send(const CanFrame frames[], size_t count) override;
+    // Frames the socket did not take, e.g. because the transmit queue was full
+    uint64_t getDroppedCount() const { return droppedCount; }
+private:
+    int socketFd = -1;
+    uint64_t droppedCount = 0;
+    // Send buffers, grown to the largest batch and then reused
+    std::vector<canfd_frame> rawFrames;
+    std::vector<iovec> ioVectors;
+    std::vector<mmsghdr> messages;
+};
+#endif
+
+struct FrameSchedulerStatistics {
+    uint64_t framesSent{};
+    uint64_t batches{};
+    // Cycles that were dropped because advance() was called too late to send them in time
+    uint64_t skippedFrames{};
+    // Microseconds between the deadline of a frame and the time it was sent
+    uint64_t maxLateness{};
+    uint64_t totalLateness{};
+    std::array<uint64_t, LATENESS_BUCKET_COUNT> latenessHistogram{};
+    double meanLateness() const { return framesSent ? static_cast<double>(totalLateness) / framesSent : 0; }
+};
+
+// Sends messages periodically for rest-bus simulation. Every message is encoded once up front,
+// so sending a frame is a copy. Deadlines are kept on a hierarchical timer wheel: a tick only
+// looks at the frames that are due in it, and frames further away move down a level once
+// every 256 ticks of the level below. Deadlines advance by whole periods, so they do not drift.
+// Time comes from the caller through advance(), or from the steady clock in run(), which counts
+// it from the Unix epoch so frames carry wall clock time stamps.
+// The scheduler is not thread-safe, apart from stop()
+class FrameScheduler {
+
+public:
+
+    // Due frames are passed to sink in batches of at most batchSize frames
+    FrameScheduler(const DbcParser& dbcFile, FrameSink& sink, uint64_t tickMicroseconds = 1000,
+        size_t batchSize = 256);
+    // Send a message every cycleTimeMs, the first time phaseMs after the scheduler starts
+    // Signals start with their initial values. Throws std::invalid_argument if the message is
+    // not in the database or is already scheduled
+    void addMessage(unsigned long msgId, unsigned int cycleTimeMs, unsigned int phaseMs = 0);
+    // Add every message that has a GenMsgCycleTime. The phases are spread over the cycle,
+    // so messages of the same cycle time do not all fall into the same tick
+    void addCyclicMessages();
+    // Change the payload that is sent from the next frame on. Only the given signals change
+    // Returns CodecStatus::ValueOutOfRange without changing the signal if the value is out of range
+    CodecStatus setSignalValue(SignalHandle handle, double physicalValue);
+    CodecStatus setSignalValues(unsigned long msgId, const std::vector<std::pair<std::string, double> >& signalValues);
+    // Stop sending a message, or send it again
+    void setActive(unsigned long msgId, bool isActive);
+    // Start the clock of the scheduler. Called by the first advance() if not called before
+    void start(uint64_t now);
+    // Send every frame that is due up to now, in microseconds. A message whose deadline
+    // passed more than one period ago is sent once, the missed cycles are skipped
+    void advance(uint64_t now);
+    // Run on the steady clock for durationMicroseconds, or until stop() is called
+    // Frames are stamped with microseconds since the Unix epoch
+    void run(uint64_t durationMicroseconds);
+    void stop() { isStopRequested.store(true, std::memory_order_relaxed); }
+    size_t getMessageCount() const { return messages.size(); }
+    FrameSchedulerStatistics getStatistics() const { return statistics; }
+    void resetStatistics() { statistics = FrameSchedulerStatistics(); }
+
+private:
+
+    static constexpr uint32_t NO_MESSAGE = 0xFFFFFFFF;
+    static constexpr unsigned int WHEEL_SLOT_COUNT = 1 << WHEEL_LEVEL_BITS;
+    struct ScheduledMessage {
+        CanFrame frame;
+        uint64_t periodTicks = 1;
+        uint64_t phaseTicks = 0;
+        uint64_t deadlineTick = 0;
+        // Next message in the same wheel slot
+        uint32_t next = NO_MESSAGE;
+        bool isActive = true;
+    };
+    const DbcParser* dbcFile;
+    FrameSink* sink;
+    uint64_t tickMicroseconds;
+    size_t batchSize;
+    std::vector<ScheduledMessage> messages;
+    // <Message id, index into messages>
+    std::unordered_map<unsigned long, uint32_t> messageIndex;
+    // Heads of the singly linked slot lists, [level][slot]
+    std::array<std::array<uint32_t, WHEEL_SLOT_COUNT>, WHEEL_LEVEL_COUNT> wheel;
+    // Next tick to process
+    uint64_t currentTick = 0;
+    bool isStarted = false;
+    std::atomic<bool> isStopRequested{ false };
+    std::vector<CanFrame> batch;
+    FrameSchedulerStatistics statistics;
+
+    void insert(uint32_t index);
+    // Move the frames of the current slot of a level down to the levels below
+    // Returns the slot index, 0 means the level above has to cascade as well
+    unsigned int cascade(unsigned int level);
+    void emit(ScheduledMessage& message, uint64_t now);
+    void flushBatch();
+
+};
+
+#endif
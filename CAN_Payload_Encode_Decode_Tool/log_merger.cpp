@@ -0,0 +1,96 @@
+/*
+ *  log_merger.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <stdexcept>
+#include "log_merger.hpp"
+
+LogMerger::LogMerger(const std::vector<std::string>& logPaths, size_t bufferSize) {
+    sources.resize(logPaths.size());
+    for (size_t i = 0; i < logPaths.size(); i++) {
+        sources[i].reader = std::make_unique<CanLogReader>(logPaths[i], bufferSize);
+    }
+    heap.reserve(sources.size());
+}
+
+void LogMerger::setChannel(size_t logIndex, unsigned int channel) {
+    if (logIndex >= sources.size()) {
+        throw std::invalid_argument("Merge failed. Log index " + std::to_string(logIndex) + " is out of range.");
+    }
+    if (isStarted) {
+        throw std::invalid_argument("Merge failed. Channels must be set before reading.");
+    }
+    sources[logIndex].hasChannel = true;
+    sources[logIndex].channel = channel;
+}
+
+bool LogMerger::readHead(size_t logIndex) {
+    Source& source = sources[logIndex];
+    if (!source.reader->next(source.head)) {
+        return false;
+    }
+    if (source.hasChannel) {
+        source.head.channel = source.channel;
+    }
+    return true;
+}
+
+void LogMerger::siftDown(size_t position) {
+    HeapEntry entry = heap[position];
+    size_t size = heap.size();
+    while (true) {
+        size_t child = position * 2 + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && heap[child + 1] < heap[child]) {
+            child++;
+        }
+        if (!(heap[child] < entry)) {
+            break;
+        }
+        heap[position] = heap[child];
+        position = child;
+    }
+    heap[position] = entry;
+}
+
+bool LogMerger::next(CanFrame& frame) {
+    if (!isStarted) {
+        isStarted = true;
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (readHead(i)) {
+                heap.push_back({ sources[i].head.timestamp, i });
+            }
+        }
+        for (size_t position = heap.size() / 2; position > 0; position--) {
+            siftDown(position - 1);
+        }
+    }
+    if (heap.empty()) {
+        return false;
+    }
+    // Hand out the earliest frame and put the next frame of its file in its place,
+    // which needs a single pass down the heap instead of a pop and a push
+    size_t logIndex = heap.front().logIndex;
+    frame = sources[logIndex].head;
+    lastLogIndex = logIndex;
+    if (readHead(logIndex)) {
+        uint64_t timestamp = sources[logIndex].head.timestamp;
+        if (timestamp < frame.timestamp) {
+            outOfOrderCount++;
+        }
+        heap.front().timestamp = timestamp;
+    }
+    else {
+        heap.front() = heap.back();
+        heap.pop_back();
+    }
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+ *  log_merger.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef LOG_MERGER_HPP
+#define LOG_MERGER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "can_log.hpp"
+#include "dbc_registry.hpp"
+
+// Merges several candump log files, e.g. one per bus, into one stream in timestamp order.
+// Every file is read sequentially in large blocks and only its next frame is kept in memory,
+// so memory use is one read buffer per file, however large the files are.
+// Frames with equal timestamps come in the order of the files, and frames of one
+// file keep their order. Frames of each file are expected in timestamp order
+class LogMerger {
+
+public:
+
+    // Throws std::invalid_argument if a file cannot be opened
+    explicit LogMerger(const std::vector<std::string>& logPaths, size_t bufferSize = 1 << 20);
+    // Frames of a file get this channel instead of the one in the file, for recorders
+    // that log every bus as can0. Must be called before the first frame is read
+    void setChannel(size_t logIndex, unsigned int channel);
+    // Next frame of all files. Returns false once every file has been read to the end
+    bool next(CanFrame& frame);
+    // File of the frame returned by the last call to next()
+    size_t getLogIndex() const { return lastLogIndex; }
+    // Frames that were older than the frame before them in the same file. They are
+    // passed on right away, so the merged stream is only ordered as far as the files are
+    uint64_t getOutOfOrderCount() const { return outOfOrderCount; }
+    // Merge and decode every frame with the database of its channel. The visitor is called as
+    // visitor(const CanFrame&, const Signal&, double physicalValue)
+    // Frames of channels without a database, or unknown to it, are skipped
+    // Returns the number of frames that were decoded
+    template <typename FrameSignalVisitor>
+    size_t mergeAndDecode(const DbcRegistry& registry, FrameSignalVisitor&& visitor) {
+        size_t decodedCount = 0;
+        CanFrame frame;
+        while (next(frame)) {
+            CodecStatus status = registry.tryDecodeSignals(frame.channel, frame.id, frame.size, frame.payload,
+                [&frame, &visitor](const Signal& sig, double value) {
+                    visitor(static_cast<const CanFrame&>(frame), sig, value);
+                });
+            if (status == CodecStatus::Ok) {
+                decodedCount++;
+            }
+        }
+        return decodedCount;
+    }
+
+private:
+
+    struct Source {
+        std::unique_ptr<CanLogReader> reader;
+        // Next frame of the file, valid while the file is in the heap
+        CanFrame head;
+        bool hasChannel = false;
+        unsigned int channel = 0;
+    };
+    // Heap entries are kept small, the frames stay in their sources
+    struct HeapEntry {
+        uint64_t timestamp;
+        size_t logIndex;
+        bool operator<(const HeapEntry& other) const {
+            return timestamp != other.timestamp ? timestamp < other.timestamp : logIndex < other.logIndex;
+        }
+    };
+
+    std::vector<Source> sources;
+    // Binary min-heap of the files that still have frames, ordered by their next frame
+    std::vector<HeapEntry> heap;
+    bool isStarted = false;
+    size_t lastLogIndex = 0;
+    uint64_t outOfOrderCount = 0;
+
+    // Read the next frame of a file into its head. Returns false at the end of the file
+    bool readHead(size_t logIndex);
+    void siftDown(size_t position);
+
+};
+
+#endif
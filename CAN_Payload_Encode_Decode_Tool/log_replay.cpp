@@ -0,0 +1,511 @@
+/*
+ *  log_replay.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <cerrno>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "log_replay.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define LOG_REPLAY_HAS_IO_URING 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+// Where the reads of a LogReplayReader are carried out
+class ReplayReadBackend {
+public:
+    virtual ~ReplayReadBackend() = default;
+    virtual void submit(int fd, char* buffer, size_t length, uint64_t offset, uint64_t tag) = 0;
+    // Start everything submitted so far
+    virtual void flush() {}
+    // Block until one read completes. result is the number of bytes read, or -errno
+    virtual uint64_t waitForCompletion(long& result) = 0;
+};
+
+namespace {
+
+    // Blocking pread calls spread over a few threads
+    class ThreadPoolBackend : public ReplayReadBackend {
+    public:
+        explicit ThreadPoolBackend(unsigned int threadCount) {
+            for (unsigned int i = 0; i < threadCount; i++) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+        ~ThreadPoolBackend() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                isStopping = true;
+            }
+            jobsAvailable.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        void submit(int fd, char* buffer, size_t length, uint64_t offset, uint64_t tag) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back(Job{ fd, buffer, length, offset, tag });
+            }
+            jobsAvailable.notify_one();
+        }
+        uint64_t waitForCompletion(long& result) override {
+            std::unique_lock<std::mutex> lock(mutex);
+            completionsAvailable.wait(lock, [this] { return !completions.empty(); });
+            auto completion = completions.front();
+            completions.pop_front();
+            result = completion.second;
+            return completion.first;
+        }
+    private:
+        struct Job {
+            int fd;
+            char* buffer;
+            size_t length;
+            uint64_t offset;
+            uint64_t tag;
+        };
+        std::mutex mutex;
+        std::condition_variable jobsAvailable;
+        std::condition_variable completionsAvailable;
+        std::deque<Job> jobs;
+        // <Tag, result>
+        std::deque<std::pair<uint64_t, long> > completions;
+        bool isStopping = false;
+        std::vector<std::thread> workers;
+        void work() {
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    jobsAvailable.wait(lock, [this] { return isStopping || !jobs.empty(); });
+                    if (isStopping) {
+                        return;
+                    }
+                    job = jobs.front();
+                    jobs.pop_front();
+                }
+                ssize_t bytesRead;
+                do {
+                    bytesRead = pread(job.fd, job.buffer, job.length, static_cast<off_t>(job.offset));
+                } while (bytesRead < 0 && errno == EINTR);
+                long result = bytesRead < 0 ? -static_cast<long>(errno) : static_cast<long>(bytesRead);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    completions.emplace_back(job.tag, result);
+                }
+                completionsAvailable.notify_one();
+            }
+        }
+    };
+
+#ifdef LOG_REPLAY_HAS_IO_URING
+
+    // Reads submitted through an io_uring instance. Talks to the kernel directly, so liburing is not needed
+    class IoUringBackend : public ReplayReadBackend {
+    public:
+        // The completion ring gets an entry for every read that can be in flight, so it never overflows
+        IoUringBackend(unsigned int submissionEntries, unsigned int completionEntries) {
+            io_uring_params params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = std::max(completionEntries, submissionEntries);
+            ringFd = static_cast<int>(syscall(__NR_io_uring_setup, submissionEntries, &params));
+            if (ringFd < 0) {
+                throw std::invalid_argument(std::string("Could not set up io_uring: ") + std::strerror(errno));
+            }
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool isSingleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (isSingleMap) {
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+            }
+            sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+            cqRing = isSingleMap ? sqRing
+                : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+            if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+                std::string error = std::string("Could not map io_uring: ") + std::strerror(errno);
+                unmap();
+                throw std::invalid_argument(error);
+            }
+            char* sq = static_cast<char*>(sqRing);
+            char* cq = static_cast<char*>(cqRing);
+            sqEntries = params.sq_entries;
+            sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+        ~IoUringBackend() override {
+            unmap();
+        }
+        void submit(int fd, char* buffer, size_t length, uint64_t offset, uint64_t tag) override {
+            if (pendingSubmissions == sqEntries) {
+                // The ring is full, hand it to the kernel before the tail wraps onto unsubmitted entries
+                enter(0);
+            }
+            unsigned int tail = *sqTail;
+            unsigned int index = tail & sqMask;
+            io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = static_cast<uint32_t>(length);
+            sqe.off = offset;
+            sqe.user_data = tag;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            pendingSubmissions++;
+        }
+        void flush() override {
+            enter(0);
+        }
+        uint64_t waitForCompletion(long& result) override {
+            unsigned int head = *cqHead;
+            while (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+                enter(1);
+            }
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            uint64_t tag = cqe.user_data;
+            result = cqe.res;
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            return tag;
+        }
+    private:
+        int ringFd = -1;
+        void* sqRing = MAP_FAILED;
+        void* cqRing = MAP_FAILED;
+        void* sqes = MAP_FAILED;
+        size_t sqRingSize = 0;
+        size_t cqRingSize = 0;
+        size_t sqesSize = 0;
+        unsigned int sqEntries = 0;
+        unsigned int* sqTail = nullptr;
+        unsigned int sqMask = 0;
+        unsigned int* sqArray = nullptr;
+        unsigned int* cqHead = nullptr;
+        unsigned int* cqTail = nullptr;
+        unsigned int cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+        unsigned int pendingSubmissions = 0;
+        // Submit pending reads and optionally wait for completions
+        void enter(unsigned int minComplete) {
+            while (pendingSubmissions || minComplete) {
+                long submitted = syscall(__NR_io_uring_enter, ringFd, pendingSubmissions, minComplete,
+                    minComplete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+                if (submitted < 0) {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                        continue;
+                    }
+                    throw std::invalid_argument(std::string("io_uring submission failed: ") + std::strerror(errno));
+                }
+                pendingSubmissions -= static_cast<unsigned int>(submitted);
+                minComplete = 0;
+            }
+        }
+        void unmap() {
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqesSize);
+            }
+            if (cqRing != MAP_FAILED && cqRing != sqRing) {
+                munmap(cqRing, cqRingSize);
+            }
+            if (sqRing != MAP_FAILED) {
+                munmap(sqRing, sqRingSize);
+            }
+            if (ringFd >= 0) {
+                close(ringFd);
+            }
+        }
+    };
+
+#endif /* LOG_REPLAY_HAS_IO_URING */
+
+}
+
+LogReplayReader::LogReplayReader(const std::vector<std::string>& logPaths, size_t chunkSize,
+    unsigned int readsInFlight, ReplayBackend backend) :
+    chunkSize(std::max<size_t>(chunkSize, 4096)),
+    // At least two, so one chunk is read while the other is decoded
+    readsInFlight(std::max(readsInFlight, 2u)),
+    requestedBackend(backend),
+    files(logPaths.size()) {
+    try {
+        for (size_t i = 0; i < logPaths.size(); i++) {
+            LogFile& file = files[i];
+            file.path = logPaths[i];
+            file.fd = open(file.path.c_str(), O_RDONLY);
+            struct stat fileStatus;
+            if (file.fd < 0 || fstat(file.fd, &fileStatus) < 0) {
+                throw std::invalid_argument("Could not open CAN log file \"" + file.path + "\".");
+            }
+            file.size = static_cast<uint64_t>(fileStatus.st_size);
+            file.isFinished = file.size == 0;
+            file.slots.resize(this->readsInFlight);
+#ifdef POSIX_FADV_SEQUENTIAL
+            posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        }
+        unsigned int slotCount = getSlotCount();
+#ifdef LOG_REPLAY_HAS_IO_URING
+        if (backend != ReplayBackend::ThreadPool) {
+            try {
+                io = std::make_unique<IoUringBackend>(std::min(slotCount, 4096u), slotCount);
+                backendInUse = ReplayBackend::IoUring;
+            }
+            catch (std::invalid_argument&) {
+                // io_uring is often disabled in containers, fall back quietly unless it was asked for
+                if (backend == ReplayBackend::IoUring) {
+                    throw;
+                }
+            }
+        }
+#else
+        if (backend == ReplayBackend::IoUring) {
+            throw std::invalid_argument("io_uring is not available on this platform.");
+        }
+#endif
+        if (!io) {
+            startThreadPool();
+        }
+    }
+    catch (...) {
+        for (auto& file : files) {
+            if (file.fd >= 0) {
+                close(file.fd);
+            }
+        }
+        throw;
+    }
+    startReads();
+}
+
+LogReplayReader::~LogReplayReader() {
+    // The kernel or a worker may still write into the buffers
+    try {
+        while (outstandingReads) {
+            long result;
+            io->waitForCompletion(result);
+            outstandingReads--;
+        }
+    }
+    catch (std::exception&) {
+    }
+    io.reset();
+    for (auto& file : files) {
+        close(file.fd);
+    }
+}
+
+unsigned int LogReplayReader::getSlotCount() const {
+    return static_cast<unsigned int>(std::max<size_t>(files.size() * readsInFlight, 1));
+}
+
+void LogReplayReader::startThreadPool() {
+    io = std::make_unique<ThreadPoolBackend>(std::min(getSlotCount(), 8u));
+    backendInUse = ReplayBackend::ThreadPool;
+}
+
+void LogReplayReader::startReads() {
+    // Fill the pipeline of every file
+    for (size_t i = 0; i < files.size(); i++) {
+        LogFile& file = files[i];
+        file.nextReadOffset = 0;
+        file.consumeSlot = 0;
+        for (size_t slot = 0; slot < readsInFlight && file.nextReadOffset < file.size; slot++) {
+            submitRead(i, slot);
+        }
+    }
+    io->flush();
+}
+
+void LogReplayReader::fallBackToThreadPool() {
+    // The other reads in the ring fail the same way, none of them wrote into a buffer
+    while (outstandingReads) {
+        long result;
+        io->waitForCompletion(result);
+        outstandingReads--;
+    }
+    startThreadPool();
+    startReads();
+}
+
+void LogReplayReader::submitRead(size_t fileIndex, size_t slotIndex) {
+    LogFile& file = files[fileIndex];
+    ReadSlot& slot = file.slots[slotIndex];
+    slot.offset = file.nextReadOffset;
+    slot.length = static_cast<size_t>(std::min<uint64_t>(chunkSize, file.size - file.nextReadOffset));
+    slot.filled = 0;
+    slot.isReady = false;
+    // Sized to the read, so small files do not each hold a whole chunk
+    if (slot.data.size() < slot.length) {
+        slot.data.resize(slot.length);
+    }
+    file.nextReadOffset += slot.length;
+    io->submit(file.fd, slot.data.data(), slot.length, slot.offset, fileIndex * readsInFlight + slotIndex);
+    outstandingReads++;
+}
+
+void LogReplayReader::waitForRead() {
+    long result;
+    uint64_t tag = io->waitForCompletion(result);
+    outstandingReads--;
+    LogFile& file = files[tag / readsInFlight];
+    ReadSlot& slot = file.slots[tag % readsInFlight];
+    if (result < 0) {
+        // Kernels before 5.6 set up rings but reject IORING_OP_READ, which is io_uring being unavailable
+        if (result == -EINVAL && !hasCompletedRead && backendInUse == ReplayBackend::IoUring
+            && requestedBackend == ReplayBackend::Automatic) {
+            fallBackToThreadPool();
+            return;
+        }
+        throw std::invalid_argument("Replay failed. Could not read \"" + file.path + "\": " + std::strerror(static_cast<int>(-result)));
+    }
+    hasCompletedRead = true;
+    slot.filled += static_cast<size_t>(result);
+    bytesRead += static_cast<uint64_t>(result);
+    if (result == 0) {
+        // The file got shorter since it was opened
+        file.size = slot.offset + slot.filled;
+        slot.isReady = true;
+    }
+    else if (slot.filled < slot.length) {
+        io->submit(file.fd, slot.data.data() + slot.filled, slot.length - slot.filled, slot.offset + slot.filled, tag);
+        outstandingReads++;
+        io->flush();
+    }
+    else {
+        slot.isReady = true;
+    }
+}
+
+void LogReplayReader::releaseChunk(size_t fileIndex) {
+    LogFile& file = files[fileIndex];
+    size_t slotIndex = file.consumeSlot;
+    ReadSlot& slot = file.slots[slotIndex];
+    slot.isReady = false;
+    file.consumeSlot = (slotIndex + 1) % file.slots.size();
+    if (slot.offset + slot.filled >= file.size) {
+        file.isFinished = true;
+    }
+    else if (file.nextReadOffset < file.size) {
+        submitRead(fileIndex, slotIndex);
+        io->flush();
+    }
+}
+
+bool LogReplayReader::startChunk(size_t fileIndex, ReplayBlock& block) {
+    LogFile& file = files[fileIndex];
+    ReadSlot& slot = file.slots[file.consumeSlot];
+    const char* data = slot.data.data();
+    const char* dataEnd = data + slot.filled;
+    bool isLastChunk = slot.offset + slot.filled >= file.size;
+    activeFile = fileIndex;
+    const char* firstNewLine = static_cast<const char*>(std::memchr(data, '\n', slot.filled));
+    if (firstNewLine == nullptr) {
+        // The whole chunk is part of one line
+        file.carry.insert(file.carry.end(), data, dataEnd);
+        releaseChunk(fileIndex);
+        if (isLastChunk && !file.carry.empty()) {
+            stage = BlockStage::FinalCarry;
+            block = ReplayBlock{ fileIndex, file.carry.data(), file.carry.data() + file.carry.size() };
+            return true;
+        }
+        return false;
+    }
+    bodyBegin = data;
+    bodyEnd = dataEnd;
+    if (!file.carry.empty()) {
+        file.carry.insert(file.carry.end(), data, firstNewLine + 1);
+        bodyBegin = firstNewLine + 1;
+    }
+    if (!isLastChunk) {
+        // The incomplete last line is kept for the next chunk
+        while (bodyEnd[-1] != '\n') {
+            bodyEnd--;
+        }
+        bodyEnd = std::max(bodyEnd, bodyBegin);
+    }
+    if (!file.carry.empty()) {
+        stage = BlockStage::Carry;
+        block = ReplayBlock{ fileIndex, file.carry.data(), file.carry.data() + file.carry.size() };
+        return true;
+    }
+    stage = BlockStage::Body;
+    block = ReplayBlock{ fileIndex, bodyBegin, bodyEnd };
+    return true;
+}
+
+void LogReplayReader::finishBody() {
+    LogFile& file = files[activeFile];
+    const ReadSlot& slot = file.slots[file.consumeSlot];
+    file.carry.assign(bodyEnd, slot.data.data() + slot.filled);
+    releaseChunk(activeFile);
+}
+
+bool LogReplayReader::nextBlock(ReplayBlock& block) {
+    // Done with what was handed out last time
+    switch (stage) {
+    case BlockStage::Carry:
+        files[activeFile].carry.clear();
+        if (bodyBegin < bodyEnd) {
+            stage = BlockStage::Body;
+            block = ReplayBlock{ activeFile, bodyBegin, bodyEnd };
+            return true;
+        }
+        finishBody();
+        break;
+    case BlockStage::Body:
+        finishBody();
+        break;
+    case BlockStage::FinalCarry:
+        files[activeFile].carry.clear();
+        break;
+    case BlockStage::None:
+        break;
+    }
+    stage = BlockStage::None;
+    while (true) {
+        bool hasUnfinishedFile = false;
+        bool hasStartedChunk = false;
+        for (size_t n = 0; n < files.size() && !hasStartedChunk; n++) {
+            size_t fileIndex = (nextFileToServe + n) % files.size();
+            LogFile& file = files[fileIndex];
+            if (file.isFinished) {
+                continue;
+            }
+            hasUnfinishedFile = true;
+            if (file.slots[file.consumeSlot].isReady) {
+                nextFileToServe = (fileIndex + 1) % files.size();
+                if (startChunk(fileIndex, block)) {
+                    return true;
+                }
+                hasStartedChunk = true;
+            }
+        }
+        if (!hasUnfinishedFile) {
+            return false;
+        }
+        if (!hasStartedChunk) {
+            waitForRead();
+        }
+    }
+}
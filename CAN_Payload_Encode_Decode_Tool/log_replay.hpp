@@ -0,0 +1,147 @@
+/*
+ *  log_replay.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef LOG_REPLAY_HPP
+#define LOG_REPLAY_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include "can_log.hpp"
+
+enum class ReplayBackend {
+    // io_uring where the kernel allows it, the thread pool otherwise
+    Automatic,
+    IoUring,
+    ThreadPool
+};
+
+// A run of complete lines from one log file
+struct ReplayBlock {
+    size_t fileIndex{};
+    const char* begin{};
+    const char* end{};
+};
+
+class ReplayReadBackend;
+
+// Replays many candump log files at once. Every file keeps several large reads in flight,
+// and while the caller parses and decodes one chunk the next ones are already being read
+// Chunks of a file are always handed out in file order, chunks of different files interleave
+class LogReplayReader {
+
+public:
+
+    explicit LogReplayReader(const std::vector<std::string>& logPaths, size_t chunkSize = 1 << 21,
+        unsigned int readsInFlight = 4, ReplayBackend backend = ReplayBackend::Automatic);
+    ~LogReplayReader();
+    LogReplayReader(const LogReplayReader&) = delete;
+    LogReplayReader& operator=(const LogReplayReader&) = delete;
+    // Next run of complete lines, valid until the next call
+    // Returns false once every file has been read to the end
+    bool nextBlock(ReplayBlock& block);
+    // Call visitor(size_t fileIndex, const CanFrame&) for every frame of every file
+    template <typename FrameVisitor>
+    void forEachFrame(FrameVisitor&& visitor) {
+        ReplayBlock block;
+        CanFrame frame;
+        while (nextBlock(block)) {
+            const char* lineBegin = block.begin;
+            while (lineBegin < block.end) {
+                const char* lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', block.end - lineBegin));
+                if (lineEnd == nullptr) {
+                    lineEnd = block.end;
+                }
+                if (parseCandumpLine(lineBegin, lineEnd, frame)) {
+                    visitor(block.fileIndex, static_cast<const CanFrame&>(frame));
+                }
+                lineBegin = lineEnd + 1;
+            }
+        }
+    }
+    // Replay and decode every frame. The visitor is called as
+    // visitor(size_t fileIndex, const CanFrame&, const Signal&, double physicalValue)
+    // Frames that are unknown to the database are skipped
+    template <typename FrameSignalVisitor>
+    void replayAndDecode(const DbcParser& dbcFile, FrameSignalVisitor&& visitor) {
+        forEachFrame([&dbcFile, &visitor](size_t fileIndex, const CanFrame& frame) {
+            dbcFile.tryDecodeSignals(frame.id, frame.size, frame.payload,
+                [fileIndex, &frame, &visitor](const Signal& sig, double value) {
+                    visitor(fileIndex, frame, sig, value);
+                });
+        });
+    }
+    ReplayBackend getBackend() const { return backendInUse; }
+    uint64_t getBytesRead() const { return bytesRead; }
+
+private:
+
+    struct ReadSlot {
+        std::vector<char> data;
+        uint64_t offset = 0;
+        size_t length = 0;
+        // Bytes read so far, reads can come back short
+        size_t filled = 0;
+        bool isReady = false;
+    };
+    struct LogFile {
+        std::string path;
+        int fd = -1;
+        uint64_t size = 0;
+        uint64_t nextReadOffset = 0;
+        // Slots are used round robin, so the next chunk in file order is always in this slot
+        size_t consumeSlot = 0;
+        std::vector<ReadSlot> slots;
+        // Start of a line that continues in the next chunk
+        std::vector<char> carry;
+        bool isFinished = false;
+    };
+    // What the last nextBlock() call handed out
+    enum class BlockStage {
+        None,
+        // The line joined across two chunks, the body of the chunk follows
+        Carry,
+        // The complete lines of the chunk
+        Body,
+        // The last, unterminated line of a file
+        FinalCarry
+    };
+    size_t chunkSize;
+    unsigned int readsInFlight;
+    ReplayBackend requestedBackend;
+    ReplayBackend backendInUse = ReplayBackend::ThreadPool;
+    std::vector<LogFile> files;
+    std::unique_ptr<ReplayReadBackend> io;
+    size_t outstandingReads = 0;
+    uint64_t bytesRead = 0;
+    // No read has succeeded yet, so nothing has been handed out
+    bool hasCompletedRead = false;
+    BlockStage stage = BlockStage::None;
+    size_t activeFile = 0;
+    const char* bodyBegin = nullptr;
+    const char* bodyEnd = nullptr;
+    // File to look at first for a ready chunk, so no file starves
+    size_t nextFileToServe = 0;
+    unsigned int getSlotCount() const;
+    void startThreadPool();
+    // Submit the first reads of every file
+    void startReads();
+    // Read everything again with the thread pool after io_uring turned out not to support reads
+    void fallBackToThreadPool();
+    void submitRead(size_t fileIndex, size_t slotIndex);
+    void waitForRead();
+    // Hand the slot of the consumed chunk back for the next read of its file
+    void releaseChunk(size_t fileIndex);
+    // Split a ready chunk into joined line and body. Returns false if there is nothing to hand out yet
+    bool startChunk(size_t fileIndex, ReplayBlock& block);
+    void finishBody();
+
+};
+
+#endif
@@ -5,9 +5,12 @@
  *      Author: Yifan Wang
  */
 
+#include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include "dbc_parser.hpp"
+#include "socketcan_reader.hpp"
 
 int main()
 {
@@ -52,6 +55,38 @@ int main()
 			std::cout << std::endl;
 		}
 		break;
+		case 3:
+		{
+#ifdef __linux__
+			// Live capture benchmark. Load the bus first, e.g. for a virtual interface:
+			// "ip link add dev vcan0 type vcan && ip link set up vcan0 && cangen vcan0 -g 0 -I 88 -L 8"
+			SocketCanReader reader("vcan0", 256);
+			uint64_t decodedSignalCount = 0;
+			auto startTime = std::chrono::steady_clock::now();
+			auto lastReportTime = startTime;
+			SocketCanStatistics lastStatistics;
+			while (std::chrono::steady_clock::now() - startTime < std::chrono::seconds(10)) {
+				reader.receiveAndDecode(dbcFile,
+					[&decodedSignalCount](const CanFrame&, const Signal&, double) { decodedSignalCount++; },
+					100);
+				auto now = std::chrono::steady_clock::now();
+				if (now - lastReportTime >= std::chrono::seconds(1)) {
+					SocketCanStatistics statistics = reader.getStatistics();
+					double seconds = std::chrono::duration<double>(now - lastReportTime).count();
+					std::cout << "Frames/s: " << (statistics.framesReceived - lastStatistics.framesReceived) / seconds
+						<< ", dropped: " << statistics.framesDropped - lastStatistics.framesDropped
+						<< ", frames per batch: " << static_cast<double>(statistics.framesReceived - lastStatistics.framesReceived)
+							/ std::max<uint64_t>(statistics.batches - lastStatistics.batches, 1)
+						<< ", signals decoded: " << decodedSignalCount << '\n';
+					lastStatistics = statistics;
+					lastReportTime = now;
+				}
+			}
+#else
+			std::cout << "Live capture requires Linux SocketCAN." << std::endl;
+#endif
+		}
+		break;
 		default:
 			break;
 		}
@@ -0,0 +1,71 @@
+/*
+ *  signal_aggregator.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <stdexcept>
+#include "signal_aggregator.hpp"
+
+SignalAggregator::SignalAggregator(const DbcParser& dbcFile, uint64_t windowLength, FlushCallback onFlush) :
+    dbcFile(dbcFile), windowLength(windowLength), onFlush(std::move(onFlush)) {
+    if (windowLength == 0) {
+        throw std::invalid_argument("Aggregation window length must be greater than 0.");
+    }
+    accumulators.resize(dbcFile.getSignalCount());
+    touchedHandles.reserve(accumulators.size());
+    summaries.reserve(accumulators.size());
+}
+
+bool SignalAggregator::feed(
+    uint64_t timestamp,
+    unsigned long msgId,
+    unsigned int msgSize,
+    unsigned char const payload[]) {
+    // Close the current window once a frame falls past it
+    uint64_t frameWindowStart = timestamp - timestamp % windowLength;
+    if (hasOpenWindow && frameWindowStart != windowStart) {
+        flush();
+    }
+    if (!hasOpenWindow) {
+        windowStart = frameWindowStart;
+        hasOpenWindow = true;
+    }
+    return dbcFile.decodeSignals(msgId, msgSize, payload,
+        [this, timestamp](const Signal& sig, double value) {
+            SignalSummary& acc = accumulators[sig.getHandle()];
+            if (acc.count == 0) {
+                acc.handle = sig.getHandle();
+                acc.min = value;
+                acc.max = value;
+                acc.sum = 0;
+                acc.firstTimestamp = timestamp;
+                touchedHandles.push_back(sig.getHandle());
+            }
+            else {
+                if (value < acc.min) { acc.min = value; }
+                if (value > acc.max) { acc.max = value; }
+            }
+            acc.count++;
+            acc.sum += value;
+            acc.last = value;
+        });
+}
+
+void SignalAggregator::flush() {
+    if (!hasOpenWindow) {
+        return;
+    }
+    summaries.clear();
+    for (SignalHandle handle : touchedHandles) {
+        summaries.push_back(accumulators[handle]);
+        // Reset the accumulator for the next window
+        accumulators[handle].count = 0;
+    }
+    touchedHandles.clear();
+    hasOpenWindow = false;
+    if (onFlush && !summaries.empty()) {
+        onFlush(windowStart, summaries);
+    }
+}
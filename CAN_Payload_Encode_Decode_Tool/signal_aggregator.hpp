@@ -0,0 +1,66 @@
+/*
+ *  signal_aggregator.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SIGNAL_AGGREGATOR_HPP
+#define SIGNAL_AGGREGATOR_HPP
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "dbc_parser.hpp"
+
+// Summary of one signal over one time window
+struct SignalSummary {
+    SignalHandle handle{};
+    uint64_t count{};
+    double min{};
+    double max{};
+    double sum{};
+    double last{};
+    // Timestamp of the first sample that fell into the window
+    uint64_t firstTimestamp{};
+    double mean() const { return count ? sum / count : 0; }
+};
+
+class SignalAggregator {
+
+public:
+
+    // Called once per closed window with the window start and the summaries of every
+    // signal that received at least one sample. The vector is reused between windows
+    typedef std::function<void(uint64_t windowStart, const std::vector<SignalSummary>& summaries)> FlushCallback;
+
+    // Timestamps can be in any unit (e.g. microseconds) as long as windowLength uses the same one.
+    // Windows are aligned to multiples of windowLength
+    SignalAggregator(const DbcParser& dbcFile, uint64_t windowLength, FlushCallback onFlush);
+    // Decode a frame straight into the accumulators. Frames must arrive in timestamp order,
+    // a frame past the current window flushes it first
+    // Returns false if the frame could not be decoded (unknown message or bus type)
+    bool feed(uint64_t timestamp,
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[]);
+    // Flush the current window even if it is not complete yet, e.g. at the end of a trace
+    void flush();
+
+private:
+
+    const DbcParser& dbcFile;
+    uint64_t windowLength;
+    FlushCallback onFlush;
+    bool hasOpenWindow = false;
+    uint64_t windowStart = 0;
+    // One accumulator per signal handle, allocated once
+    std::vector<SignalSummary> accumulators;
+    // Handles that got a sample in the current window, so a flush does not scan every signal
+    std::vector<SignalHandle> touchedHandles;
+    // Output buffer handed to the callback
+    std::vector<SignalSummary> summaries;
+
+};
+
+#endif
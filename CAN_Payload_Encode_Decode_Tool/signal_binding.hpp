@@ -0,0 +1,125 @@
+/*
+ *  signal_binding.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SIGNAL_BINDING_HPP
+#define SIGNAL_BINDING_HPP
+
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+#include "dbc_parser.hpp"
+
+// Decodes the signals of one message straight into the members of a user struct, e.g.
+//     struct EngineData { float speed; int temperature; Gear gear; };
+//     SignalBinding<EngineData> binding(dbcFile, 258);
+//     binding.bind("EngSpeed", &EngineData::speed).bind("EngTemp", &EngineData::temperature);
+// Signals are looked up once in bind(). Decoding only extracts the bound signals and
+// writes them through a table of member pointers, without names or a result map.
+// Members can be floating point, integer, bool or enum types. Integers are rounded half
+// away from zero and clamped to the range of the member
+template <typename Target>
+class SignalBinding {
+
+public:
+
+    // Throws std::invalid_argument if the message is not in the database
+    SignalBinding(const DbcParser& dbcFile, unsigned long msgId) : dbcFile(&dbcFile), msgId(msgId) {
+        const Message* message = dbcFile.getMessage(msgId);
+        if (message == nullptr) {
+            throw std::invalid_argument("Binding failed. Cannot find message (ID: "
+                + std::to_string(msgId) + ") in CAN database.");
+        }
+        dlc = message->getDlc();
+        maxMsgLen = dbcFile.getMaxMessageLength();
+    }
+    // Throws std::invalid_argument if the message has no signal of this name
+    template <typename Member>
+    SignalBinding& bind(const std::string& sigName, Member Target::* member) {
+        std::optional<SignalHandle> handle = dbcFile->getSignalHandle(msgId, sigName);
+        if (!handle.has_value()) {
+            throw std::invalid_argument("Binding failed. Cannot find signal: "
+                + sigName + " in message (ID: " + std::to_string(msgId) + ").");
+        }
+        return bind(*handle, member);
+    }
+    template <typename Member>
+    SignalBinding& bind(SignalHandle handle, Member Target::* member) {
+        static_assert(std::is_arithmetic_v<Member> || std::is_enum_v<Member>,
+            "Signals can only be bound to arithmetic or enum members");
+        const Signal* sig = dbcFile->getSignal(handle);
+        if (sig == nullptr || dbcFile->getMessageOfSignal(handle)->getId() != msgId) {
+            throw std::invalid_argument("Binding failed. Signal handle "
+                + std::to_string(handle) + " does not belong to message (ID: " + std::to_string(msgId) + ").");
+        }
+        // Pointers to data members can be converted to another member type and back
+        fields.push_back({ sig, reinterpret_cast<char Target::*>(member), &store<Member> });
+        return *this;
+    }
+    // Decode the bound signals of a frame into target. Members that are not bound are left alone
+    CodecStatus decode(unsigned int msgSize, unsigned char const payload[], Target& target) const {
+        if (maxMsgLen == 0) {
+            return CodecStatus::UnknownBusType;
+        }
+        if (msgSize != dlc) {
+            return CodecStatus::DlcMismatch;
+        }
+        for (const Field& field : fields) {
+            field.store(target, field.member, field.signal->rawToPhysical(field.signal->extractRawValue(payload)));
+        }
+        return CodecStatus::Ok;
+    }
+    unsigned long getMessageId() const { return msgId; }
+    size_t getFieldCount() const { return fields.size(); }
+
+private:
+
+    typedef void (*StoreFunction)(Target& target, char Target::* member, double physicalValue);
+    struct Field {
+        const Signal* signal;
+        char Target::* member;
+        StoreFunction store;
+    };
+    const DbcParser* dbcFile;
+    unsigned long msgId;
+    unsigned int dlc = 0;
+    unsigned short maxMsgLen = 0;
+    std::vector<Field> fields;
+
+    template <typename Member>
+    static void store(Target& target, char Target::* member, double physicalValue) {
+        target.*reinterpret_cast<Member Target::*>(member) = convert<Member>(physicalValue);
+    }
+    template <typename Member>
+    static Member convert(double physicalValue) {
+        if constexpr (std::is_enum_v<Member>) {
+            return static_cast<Member>(convert<std::underlying_type_t<Member> >(physicalValue));
+        }
+        else if constexpr (std::is_same_v<Member, bool>) {
+            return physicalValue != 0;
+        }
+        else if constexpr (std::is_floating_point_v<Member>) {
+            return static_cast<Member>(physicalValue);
+        }
+        else {
+            double rounded = std::round(physicalValue);
+            if (!(rounded > static_cast<double>(std::numeric_limits<Member>::lowest()))) {
+                return std::numeric_limits<Member>::lowest();
+            }
+            if (rounded >= static_cast<double>(std::numeric_limits<Member>::max())) {
+                return std::numeric_limits<Member>::max();
+            }
+            return static_cast<Member>(rounded);
+        }
+    }
+
+};
+
+#endif
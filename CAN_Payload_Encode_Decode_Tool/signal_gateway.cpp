@@ -0,0 +1,146 @@
+/*
+ *  signal_gateway.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "signal_gateway.hpp"
+
+namespace {
+
+    GatewayRouteKind chooseRouteKind(const Signal& source, const Signal& target) {
+        if (source.getFactor() != target.getFactor() || source.getOffset() != target.getOffset()
+            || source.getValueTypes() != target.getValueTypes()) {
+            return GatewayRouteKind::Physical;
+        }
+        unsigned int sourceSize = source.getSignalSize();
+        unsigned int targetSize = target.getSignalSize();
+        switch (source.getValueTypes()) {
+        case ValueType::Unsigned:
+            // Zero extended by the copy
+            return targetSize >= sourceSize ? GatewayRouteKind::RawCopy : GatewayRouteKind::Physical;
+        case ValueType::Signed:
+            if (targetSize == sourceSize) {
+                return GatewayRouteKind::RawCopy;
+            }
+            return targetSize > sourceSize && sourceSize > 0 ? GatewayRouteKind::RawSignExtend : GatewayRouteKind::Physical;
+        case ValueType::IeeeFloat:
+        case ValueType::IeeeDouble:
+            return targetSize == sourceSize ? GatewayRouteKind::RawCopy : GatewayRouteKind::Physical;
+        default:
+            return GatewayRouteKind::Physical;
+        }
+    }
+
+    // Lowest and highest raw value of an integer signal, as raw bits
+    std::pair<uint64_t, uint64_t> rawBitsRange(const Signal& sig) {
+        unsigned int size = sig.getSignalSize();
+        uint64_t allBits = size >= 64 ? ~0ULL : (1ULL << size) - 1;
+        if (sig.getValueTypes() == ValueType::Signed && size > 0) {
+            uint64_t signBit = 1ULL << (size - 1);
+            return { signBit, signBit - 1 };
+        }
+        return { 0, allBits };
+    }
+
+}
+
+SignalGateway::SignalGateway(const DbcParser& sourceDbcFile, const DbcParser& targetDbcFile) :
+    sourceDbcFile(&sourceDbcFile), targetDbcFile(&targetDbcFile),
+    targetMaxMessageLength(targetDbcFile.getMaxMessageLength()),
+    isRoutedTarget(targetDbcFile.getSignalCount(), false) {
+    if (sourceDbcFile.getMaxMessageLength() == 0 || targetMaxMessageLength == 0) {
+        throw std::invalid_argument("Gateway failed. The bus type of a database is not set.");
+    }
+}
+
+GatewayRouteKind SignalGateway::addRoute(unsigned long sourceMsgId, const std::string& sourceSignal,
+    unsigned long targetMsgId, const std::string& targetSignal) {
+    std::optional<SignalHandle> sourceHandle = sourceDbcFile->getSignalHandle(sourceMsgId, sourceSignal);
+    if (!sourceHandle.has_value()) {
+        throw std::invalid_argument("Gateway failed. Cannot find signal \"" + sourceSignal
+            + "\" in message (ID: " + std::to_string(sourceMsgId) + ").");
+    }
+    std::optional<SignalHandle> targetHandle = targetDbcFile->getSignalHandle(targetMsgId, targetSignal);
+    if (!targetHandle.has_value()) {
+        throw std::invalid_argument("Gateway failed. Cannot find signal \"" + targetSignal
+            + "\" in message (ID: " + std::to_string(targetMsgId) + ").");
+    }
+    return addRoute(*sourceHandle, *targetHandle);
+}
+
+GatewayRouteKind SignalGateway::addRoute(SignalHandle sourceHandle, SignalHandle targetHandle) {
+    const Signal* sourceSignal = sourceDbcFile->getSignal(sourceHandle);
+    const Signal* targetSignal = targetDbcFile->getSignal(targetHandle);
+    if (sourceSignal == nullptr || targetSignal == nullptr) {
+        throw std::invalid_argument("Gateway failed. Signal handle is out of range.");
+    }
+    if (isRoutedTarget[targetHandle]) {
+        throw std::invalid_argument("Gateway failed. Signal \"" + targetSignal->getName()
+            + "\" already has a route.");
+    }
+    const Message& sourceMessage = *sourceDbcFile->getMessageOfSignal(sourceHandle);
+    Route route;
+    route.source = sourceSignal;
+    route.target = targetSignal;
+    route.targetIndex = findOrAddTarget(*targetDbcFile->getMessageOfSignal(targetHandle));
+    route.kind = chooseRouteKind(*sourceSignal, *targetSignal);
+    if (route.kind != GatewayRouteKind::Physical && (sourceSignal->getValueTypes() == ValueType::Unsigned
+        || sourceSignal->getValueTypes() == ValueType::Signed)) {
+        // The check is monotonic in the raw value, so the two ends decide for all values
+        std::pair<uint64_t, uint64_t> range = rawBitsRange(*sourceSignal);
+        route.needsRangeCheck = !targetSignal->isInRange(sourceSignal->rawToPhysical(range.first))
+            || !targetSignal->isInRange(sourceSignal->rawToPhysical(range.second));
+    }
+    // Not read from the target payload, which holds whatever was routed last
+    if (targetSignal->getInitialValue().has_value()) {
+        // DBC stores initial values as raw values, converted the same way the codec does
+        route.initialValue = targetSignal->getInitialValue().value() * targetSignal->getFactor()
+            + targetSignal->getOffset();
+    }
+    else {
+        const unsigned char zeroPayload[MAX_MSG_LEN_CAN_FD]{};
+        route.initialValue = targetSignal->rawToPhysical(targetSignal->extractRawValue(zeroPayload));
+    }
+    SourceMessage& source = sources[sourceMessage.getId()];
+    source.size = sourceMessage.getDlc();
+    // Kept sorted by target, routes to the same target stay in the order they were added
+    auto position = std::upper_bound(source.routes.begin(), source.routes.end(), route.targetIndex,
+        [](unsigned int targetIndex, const Route& other) { return targetIndex < other.targetIndex; });
+    source.routes.insert(position, route);
+    isRoutedTarget[targetHandle] = true;
+    routeCount++;
+    if (route.kind != GatewayRouteKind::Physical) {
+        rawRouteCount++;
+    }
+    return route.kind;
+}
+
+unsigned int SignalGateway::findOrAddTarget(const Message& message) {
+    auto found = targetIndexById.find(message.getId());
+    if (found != targetIndexById.end()) {
+        return found->second;
+    }
+    CanFrame frame{};
+    frame.id = message.getId();
+    // Encoding without values gives every signal its initial value
+    CodecStatus status = targetDbcFile->tryEncode(frame.id, std::vector<std::pair<std::string, double> >(),
+        frame.payload, MAX_MSG_LEN_CAN_FD, frame.size);
+    if (status != CodecStatus::Ok && status != CodecStatus::ValueOutOfRange) {
+        throw std::invalid_argument("Gateway failed. Cannot encode message (ID: "
+            + std::to_string(frame.id) + "): " + toString(status) + ".");
+    }
+    unsigned int index = static_cast<unsigned int>(targets.size());
+    targets.push_back(frame);
+    targetIndexById.emplace(frame.id, index);
+    return index;
+}
+
+const CanFrame* SignalGateway::getTargetFrame(unsigned long targetMsgId) const {
+    auto found = targetIndexById.find(targetMsgId);
+    return found == targetIndexById.end() ? nullptr : &targets[found->second];
+}
@@ -0,0 +1,136 @@
+/*
+ *  signal_gateway.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SIGNAL_GATEWAY_HPP
+#define SIGNAL_GATEWAY_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+
+// How a route moves its value, decided once when the route is added
+enum class GatewayRouteKind {
+    // Same factor, offset and value type and room for every value: the raw bits are copied
+    RawCopy,
+    // Same as RawCopy, but a signed value is widened, so its sign bit is extended
+    RawSignExtend,
+    // Scaling or value type differ: decoded to the physical value and encoded again
+    Physical
+};
+// With every kind, values out of the range of the target signal are replaced by its initial
+// value, as in tryEncode. Raw routes skip the check when the target range holds every value
+// the source bits can have
+
+// Copies signals from incoming frames into outgoing frames, e.g. for a gateway between
+// two buses, which may use two different databases. Routes are resolved to signals when they
+// are added, so routing a frame needs no name lookup, no map and no allocation.
+// Every target message keeps its payload between frames, starting with the initial values
+// of its signals, so signals routed from different source messages are merged
+class SignalGateway {
+
+public:
+
+    // sourceDbcFile describes the incoming frames, targetDbcFile the outgoing ones
+    // They can be the same parser. Both must outlive the gateway
+    SignalGateway(const DbcParser& sourceDbcFile, const DbcParser& targetDbcFile);
+    // Route a source signal into a target signal. Throws std::invalid_argument if a message
+    // or signal is unknown or the target signal already has a route. Returns how the value is moved
+    GatewayRouteKind addRoute(unsigned long sourceMsgId, const std::string& sourceSignal,
+        unsigned long targetMsgId, const std::string& targetSignal);
+    GatewayRouteKind addRoute(SignalHandle sourceHandle, SignalHandle targetHandle);
+    // Update the target messages with the routed signals of one frame, then call
+    // onFrame(const CanFrame&) once per target message that was updated. The target frames
+    // get the timestamp and channel of the incoming frame
+    // Frames without routes return CodecStatus::UnknownMessage and are left alone
+    template <typename FrameVisitor>
+    CodecStatus route(const CanFrame& frame, FrameVisitor&& onFrame) {
+        auto found = sources.find(frame.id);
+        if (found == sources.end()) {
+            return CodecStatus::UnknownMessage;
+        }
+        const SourceMessage& source = found->second;
+        if (frame.size != source.size) {
+            return CodecStatus::DlcMismatch;
+        }
+        // Routes are sorted by target, so every target is complete before the next one starts
+        size_t routeCount = source.routes.size();
+        for (size_t i = 0; i < routeCount; i++) {
+            const Route& route = source.routes[i];
+            CanFrame& target = targets[route.targetIndex];
+            applyRoute(route, frame.payload, target.payload);
+            if (i + 1 == routeCount || source.routes[i + 1].targetIndex != route.targetIndex) {
+                target.timestamp = frame.timestamp;
+                target.channel = frame.channel;
+                onFrame(static_cast<const CanFrame&>(target));
+            }
+        }
+        return CodecStatus::Ok;
+    }
+    // Current payload of a target message, nullptr if no route leads to it
+    const CanFrame* getTargetFrame(unsigned long targetMsgId) const;
+    size_t getRouteCount() const { return routeCount; }
+    // Routes that copy raw bits instead of converting through the physical value
+    size_t getRawRouteCount() const { return rawRouteCount; }
+    // Values of physical and raw routes that were replaced by the initial value of their target
+    uint64_t getOutOfRangeCount() const { return outOfRangeCount; }
+
+private:
+
+    struct Route {
+        const Signal* source = nullptr;
+        const Signal* target = nullptr;
+        unsigned int targetIndex = 0;
+        GatewayRouteKind kind = GatewayRouteKind::RawCopy;
+        // Always set for Physical routes
+        bool needsRangeCheck = true;
+        // Physical value the target starts with, used for out of range values
+        double initialValue = 0;
+    };
+    struct SourceMessage {
+        unsigned int size = 0;
+        std::vector<Route> routes;
+    };
+
+    const DbcParser* sourceDbcFile;
+    const DbcParser* targetDbcFile;
+    unsigned short targetMaxMessageLength;
+    std::unordered_map<unsigned long, SourceMessage> sources;
+    std::vector<CanFrame> targets;
+    std::unordered_map<unsigned long, unsigned int> targetIndexById;
+    // Target signals that already have a route, by handle
+    std::vector<bool> isRoutedTarget;
+    size_t routeCount = 0;
+    size_t rawRouteCount = 0;
+    uint64_t outOfRangeCount = 0;
+
+    void applyRoute(const Route& route, unsigned char const sourcePayload[], unsigned char targetPayload[]) {
+        uint64_t rawBits = route.source->extractRawValue(sourcePayload);
+        if (route.needsRangeCheck) {
+            double physicalValue = route.source->rawToPhysical(rawBits);
+            if (!route.target->isInRange(physicalValue)) {
+                outOfRangeCount++;
+                route.target->encodeSignal(route.initialValue, targetPayload, targetMaxMessageLength);
+                return;
+            }
+            if (route.kind == GatewayRouteKind::Physical) {
+                route.target->encodeSignal(physicalValue, targetPayload, targetMaxMessageLength);
+                return;
+            }
+        }
+        if (route.kind == GatewayRouteKind::RawSignExtend) {
+            uint64_t signBit = 1ULL << (route.source->getSignalSize() - 1);
+            rawBits = (rawBits ^ signBit) - signBit;
+        }
+        route.target->insertRawValue(rawBits, targetPayload, targetMaxMessageLength);
+    }
+    unsigned int findOrAddTarget(const Message& message);
+
+};
+
+#endif
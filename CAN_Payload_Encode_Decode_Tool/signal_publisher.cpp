@@ -0,0 +1,218 @@
+/*
+ *  signal_publisher.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <bit>
+#include <new>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "signal_publisher.hpp"
+
+namespace {
+
+    constexpr size_t RECORD_ALIGNMENT = 64;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // POSIX shared memory names start with a slash
+    std::string toShmName(const std::string& name) {
+        return !name.empty() && name.front() == '/' ? name : "/" + name;
+    }
+
+}
+
+SignalPublisher::SignalPublisher(const DbcParser& dbcFile, const std::string& name, uint64_t recordCapacity) :
+    dbcFile(&dbcFile), name(toShmName(name)) {
+    recordCapacity = std::bit_ceil(std::max<uint64_t>(recordCapacity, 1));
+    recordMask = recordCapacity - 1;
+
+    // Names and units, each followed by a null. Taken from the signal index, so
+    // lazily loaded messages are not parsed until they are published
+    SignalHandle signalCount = dbcFile.getSignalCount();
+    std::string strings;
+    std::vector<SharedSignalEntry> directory(signalCount);
+    size_t directoryOffset = sizeof(SharedRingHeader);
+    size_t stringsOffset = directoryOffset + signalCount * sizeof(SharedSignalEntry);
+    for (SignalHandle handle = 0; handle < signalCount; handle++) {
+        std::string_view sigName = dbcFile.getSignalName(handle).substr(0, UINT16_MAX);
+        std::string_view unit = dbcFile.getSignalUnit(handle).substr(0, UINT16_MAX);
+        SharedSignalEntry& entry = directory[handle];
+        entry.msgId = static_cast<uint32_t>(*dbcFile.getMessageIdOfSignal(handle));
+        entry.nameOffset = static_cast<uint32_t>(stringsOffset + strings.size());
+        entry.nameLength = static_cast<uint16_t>(sigName.size());
+        strings.append(sigName).push_back('\0');
+        entry.unitOffset = static_cast<uint32_t>(stringsOffset + strings.size());
+        entry.unitLength = static_cast<uint16_t>(unit.size());
+        strings.append(unit).push_back('\0');
+    }
+    size_t recordsOffset = alignUp(stringsOffset + strings.size(), RECORD_ALIGNMENT);
+    mappingSize = recordsOffset + recordCapacity * sizeof(SharedSignalRecord);
+
+    // A leftover object of a publisher that did not exit cleanly is replaced, not reused
+    shm_unlink(this->name.c_str());
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::invalid_argument("Could not create shared memory \"" + this->name + "\": " + std::strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) != 0
+        || (mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        std::string error = "Could not map shared memory \"" + this->name + "\": " + std::strerror(errno);
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw std::invalid_argument(error);
+    }
+    close(fd);
+
+    char* base = static_cast<char*>(mapping);
+    header = new (base) SharedRingHeader{};
+    header->version = SHARED_RING_VERSION;
+    header->signalCount = signalCount;
+    header->recordCapacity = recordCapacity;
+    header->directoryOffset = directoryOffset;
+    header->recordsOffset = recordsOffset;
+    header->totalSize = mappingSize;
+    std::memcpy(base + directoryOffset, directory.data(), directory.size() * sizeof(SharedSignalEntry));
+    std::memcpy(base + stringsOffset, strings.data(), strings.size());
+    records = new (base + recordsOffset) SharedSignalRecord[recordCapacity]{};
+    // Readers that map the object before this point reject it
+    header->magic.store(SHARED_RING_MAGIC, std::memory_order_release);
+}
+
+SignalPublisher::~SignalPublisher() {
+    munmap(mapping, mappingSize);
+    shm_unlink(name.c_str());
+}
+
+void SignalPublisher::write(uint64_t timestamp, unsigned int channel, SignalHandle handle, double value) {
+    SharedSignalRecord& record = records[nextSequence & recordMask];
+    // Odd while writing, so a reader that sees the same even number before and after
+    // copying the record knows that it was not overwritten in between
+    record.sequence.store(nextSequence * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.timestamp.store(timestamp, std::memory_order_relaxed);
+    record.value.store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+    record.handle.store(handle, std::memory_order_relaxed);
+    record.channel.store(channel, std::memory_order_relaxed);
+    record.sequence.store(nextSequence * 2 + 2, std::memory_order_release);
+    nextSequence++;
+}
+
+CodecStatus SignalPublisher::publishFrame(const CanFrame& frame) {
+    CodecStatus status = dbcFile->tryDecodeSignals(frame.id, frame.size, frame.payload,
+        [this, &frame](const Signal& sig, double value) {
+            write(frame.timestamp, frame.channel, sig.getHandle(), value);
+        });
+    commit();
+    return status;
+}
+
+SignalSubscriber::SignalSubscriber(const std::string& name, bool startAtOldest) {
+    std::string shmName = toShmName(name);
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::invalid_argument("Could not open shared memory \"" + shmName + "\": " + std::strerror(errno));
+    }
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(SharedRingHeader)
+        || (mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        mapping = nullptr;
+        close(fd);
+        throw std::invalid_argument("Could not map shared memory \"" + shmName + "\".");
+    }
+    close(fd);
+    mappingSize = static_cast<size_t>(status.st_size);
+
+    const char* base = static_cast<const char*>(mapping);
+    header = reinterpret_cast<const SharedRingHeader*>(base);
+    if (header->magic.load(std::memory_order_acquire) != SHARED_RING_MAGIC
+        || header->version != SHARED_RING_VERSION || header->totalSize != mappingSize
+        || !std::has_single_bit(header->recordCapacity)
+        || header->directoryOffset + header->signalCount * sizeof(SharedSignalEntry) > header->recordsOffset
+        || header->recordsOffset + header->recordCapacity * sizeof(SharedSignalRecord) != mappingSize) {
+        munmap(mapping, mappingSize);
+        throw std::invalid_argument("Shared memory \"" + shmName + "\" is not a signal ring of this version.");
+    }
+    directory = reinterpret_cast<const SharedSignalEntry*>(base + header->directoryOffset);
+    records = reinterpret_cast<const SharedSignalRecord*>(base + header->recordsOffset);
+    recordMask = header->recordCapacity - 1;
+    readSequence = header->writeSequence.load(std::memory_order_acquire);
+    if (startAtOldest) {
+        readSequence -= std::min(readSequence, header->recordCapacity);
+    }
+}
+
+SignalSubscriber::~SignalSubscriber() {
+    munmap(mapping, mappingSize);
+}
+
+std::string_view SignalSubscriber::getSignalName(SignalHandle handle) const {
+    if (handle >= header->signalCount) {
+        return {};
+    }
+    return std::string_view(static_cast<const char*>(mapping) + directory[handle].nameOffset, directory[handle].nameLength);
+}
+
+std::string_view SignalSubscriber::getSignalUnit(SignalHandle handle) const {
+    if (handle >= header->signalCount) {
+        return {};
+    }
+    return std::string_view(static_cast<const char*>(mapping) + directory[handle].unitOffset, directory[handle].unitLength);
+}
+
+std::optional<unsigned long> SignalSubscriber::getMessageId(SignalHandle handle) const {
+    if (handle >= header->signalCount) {
+        return std::nullopt;
+    }
+    return directory[handle].msgId;
+}
+
+std::optional<SignalHandle> SignalSubscriber::findSignal(unsigned long msgId, std::string_view sigName) const {
+    for (SignalHandle handle = 0; handle < header->signalCount; handle++) {
+        if (directory[handle].msgId == msgId && getSignalName(handle) == sigName) {
+            return handle;
+        }
+    }
+    return std::nullopt;
+}
+
+size_t SignalSubscriber::poll(SignalRecord out[], size_t maxRecords) {
+    uint64_t available = header->writeSequence.load(std::memory_order_acquire);
+    // Everything older than one ring has been overwritten already
+    if (available - readSequence > header->recordCapacity) {
+        lostCount += available - header->recordCapacity - readSequence;
+        readSequence = available - header->recordCapacity;
+    }
+    size_t count = 0;
+    for (; readSequence < available && count < maxRecords; readSequence++) {
+        const SharedSignalRecord& record = records[readSequence & recordMask];
+        uint64_t expected = readSequence * 2 + 2;
+        if (record.sequence.load(std::memory_order_acquire) != expected) {
+            // The writer has lapped this reader since writeSequence was loaded
+            lostCount++;
+            continue;
+        }
+        SignalRecord& copy = out[count];
+        copy.timestamp = record.timestamp.load(std::memory_order_relaxed);
+        copy.value = std::bit_cast<double>(record.value.load(std::memory_order_relaxed));
+        copy.handle = record.handle.load(std::memory_order_relaxed);
+        copy.channel = record.channel.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (record.sequence.load(std::memory_order_relaxed) != expected) {
+            lostCount++;
+            continue;
+        }
+        count++;
+    }
+    return count;
+}
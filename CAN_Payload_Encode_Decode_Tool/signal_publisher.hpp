@@ -0,0 +1,148 @@
+/*
+ *  signal_publisher.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SIGNAL_PUBLISHER_HPP
+#define SIGNAL_PUBLISHER_HPP
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+
+// Layout of the shared memory object, all offsets are from its start:
+//     SharedRingHeader
+//     SharedSignalEntry[signalCount], indexed by signal handle
+//     Names and units, null-terminated
+//     SharedSignalRecord[recordCapacity], 64-byte aligned
+constexpr uint64_t SHARED_RING_MAGIC = 0x31304D4853434244ULL; // "DBCSHM01"
+constexpr uint32_t SHARED_RING_VERSION = 1;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "Atomics in shared memory must be lock-free");
+
+struct SharedRingHeader {
+    // Written last, once everything else is in place
+    std::atomic<uint64_t> magic;
+    uint32_t version;
+    uint32_t signalCount;
+    uint64_t recordCapacity;
+    uint64_t directoryOffset;
+    uint64_t recordsOffset;
+    uint64_t totalSize;
+    // Number of records published so far. Record n is in slot n % recordCapacity
+    alignas(64) std::atomic<uint64_t> writeSequence;
+};
+
+struct SharedSignalEntry {
+    uint32_t msgId;
+    uint32_t nameOffset;
+    uint32_t unitOffset;
+    uint16_t nameLength;
+    uint16_t unitLength;
+};
+
+struct SharedSignalRecord {
+    // 2n + 1 while record n is being written, 2n + 2 once it is complete
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> timestamp;
+    // Bits of the double
+    std::atomic<uint64_t> value;
+    std::atomic<uint32_t> handle;
+    std::atomic<uint32_t> channel;
+};
+
+// A record as the subscriber hands it out
+struct SignalRecord {
+    // Microseconds, taken from the frame
+    uint64_t timestamp{};
+    SignalHandle handle{};
+    unsigned int channel{};
+    double value{};
+};
+
+// Decodes once and publishes every signal value into a POSIX shared memory ring,
+// from which any number of local processes can read with SignalSubscriber.
+// The ring starts with a directory of all signals, so readers need no DBC file.
+// The writer never waits for readers: old records are simply overwritten, and a reader
+// that falls a whole ring behind skips ahead and counts what it lost
+class SignalPublisher {
+
+public:
+
+    // name is the POSIX shared memory name, e.g. "/can_signals". An existing object of
+    // that name is replaced. recordCapacity is rounded up to a power of two
+    SignalPublisher(const DbcParser& dbcFile, const std::string& name, uint64_t recordCapacity = 1 << 16);
+    // Removes the name, processes that still have it open keep their mapping
+    ~SignalPublisher();
+    SignalPublisher(const SignalPublisher&) = delete;
+    SignalPublisher& operator=(const SignalPublisher&) = delete;
+    // Decode a frame and publish all its signals at once
+    CodecStatus publishFrame(const CanFrame& frame);
+    void publish(uint64_t timestamp, unsigned int channel, SignalHandle handle, double value) {
+        write(timestamp, channel, handle, value);
+        commit();
+    }
+    uint64_t getPublishedCount() const { return nextSequence; }
+
+private:
+
+    const DbcParser* dbcFile;
+    std::string name;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    SharedRingHeader* header = nullptr;
+    SharedSignalRecord* records = nullptr;
+    uint64_t recordMask = 0;
+    uint64_t nextSequence = 0;
+
+    void write(uint64_t timestamp, unsigned int channel, SignalHandle handle, double value);
+    // Make the records written so far visible to readers
+    void commit() { header->writeSequence.store(nextSequence, std::memory_order_release); }
+
+};
+
+// Reads the ring of a SignalPublisher, zero-copy for the directory.
+// Each subscriber keeps its own position, readers never write to the shared memory
+class SignalSubscriber {
+
+public:
+
+    // Throws std::invalid_argument if there is no publisher of that name or its ring has
+    // another layout. Reading starts with the next record unless startAtOldest is set
+    explicit SignalSubscriber(const std::string& name, bool startAtOldest = false);
+    ~SignalSubscriber();
+    SignalSubscriber(const SignalSubscriber&) = delete;
+    SignalSubscriber& operator=(const SignalSubscriber&) = delete;
+    uint32_t getSignalCount() const { return header->signalCount; }
+    // Views into the shared memory, empty if the handle is out of range
+    std::string_view getSignalName(SignalHandle handle) const;
+    std::string_view getSignalUnit(SignalHandle handle) const;
+    std::optional<unsigned long> getMessageId(SignalHandle handle) const;
+    // Handle of a signal by message and name, searched linearly
+    std::optional<SignalHandle> findSignal(unsigned long msgId, std::string_view sigName) const;
+    // Copy up to maxRecords new records into records. Returns the number copied
+    size_t poll(SignalRecord records[], size_t maxRecords);
+    // Records that were overwritten before this subscriber could read them
+    uint64_t getLostCount() const { return lostCount; }
+
+private:
+
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    const SharedRingHeader* header = nullptr;
+    const SharedSignalEntry* directory = nullptr;
+    const SharedSignalRecord* records = nullptr;
+    uint64_t recordMask = 0;
+    uint64_t readSequence = 0;
+    uint64_t lostCount = 0;
+
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ *  signal_value_table.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include <bit>
+#include <thread>
+#include "signal_value_table.hpp"
+
+SignalValueTable::SignalValueTable(const DbcParser& dbcFile) :
+    dbcFile(&dbcFile), slotOfHandle(dbcFile.getSignalCount()), values(dbcFile.getSignalCount()) {
+    // Handles of a message are contiguous, so every run of handles with the same message is one slot
+    // Message IDs are unique, and reading them does not parse lazily loaded messages
+    std::vector<std::pair<unsigned long, SignalHandle> > runs;
+    for (SignalHandle handle = 0; handle < dbcFile.getSignalCount(); handle++) {
+        unsigned long msgId = *dbcFile.getMessageIdOfSignal(handle);
+        if (runs.empty() || runs.back().first != msgId) {
+            runs.emplace_back(msgId, handle);
+        }
+        slotOfHandle[handle] = static_cast<uint32_t>(runs.size() - 1);
+    }
+    slots = std::vector<MessageSlot>(runs.size());
+    for (uint32_t i = 0; i < runs.size(); i++) {
+        MessageSlot& slot = slots[i];
+        slot.msgId = runs[i].first;
+        slot.firstHandle = runs[i].second;
+        SignalHandle end = i + 1 < runs.size() ? runs[i + 1].second : dbcFile.getSignalCount();
+        slot.signalCount = end - slot.firstHandle;
+        slotOfMessage.emplace(slot.msgId, i);
+    }
+}
+
+CodecStatus SignalValueTable::update(uint64_t timestamp,
+    unsigned long msgId,
+    unsigned int msgSize,
+    unsigned char const payload[]) {
+    // Opened at the first signal, which also tells the slot without another lookup.
+    // J1939 messages found by their PGN land in the slot of the database message
+    MessageSlot* slot = nullptr;
+    uint64_t sequence = 0;
+    CodecStatus status = dbcFile->tryDecodeSignals(msgId, msgSize, payload,
+        [this, &slot, &sequence](const Signal& sig, double value) {
+            SignalHandle handle = sig.getHandle();
+            if (slot == nullptr) {
+                slot = &slots[slotOfHandle[handle]];
+                sequence = slot->sequence.load(std::memory_order_relaxed);
+                slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+            values[handle].store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+        });
+    if (slot != nullptr) {
+        slot->timestamp.store(timestamp, std::memory_order_relaxed);
+        slot->sequence.store(sequence + 2, std::memory_order_release);
+    }
+    return status;
+}
+
+template <typename Copy>
+uint64_t SignalValueTable::readConsistent(const MessageSlot& slot, Copy&& copy) const {
+    for (unsigned int attempt = 0;; attempt++) {
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == 0) {
+            return 0;
+        }
+        if ((before & 1) == 0) {
+            copy();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                return before;
+            }
+        }
+        // The writer was preempted in the middle of an update, let it finish
+        if (attempt >= 64) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+std::optional<SignalSample> SignalValueTable::getLatest(SignalHandle handle) const {
+    if (handle >= values.size()) {
+        return std::nullopt;
+    }
+    SignalSample sample;
+    const MessageSlot& slot = slots[slotOfHandle[handle]];
+    uint64_t sequence = readConsistent(slot, [this, &slot, &sample, handle]() {
+        sample.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        sample.value = std::bit_cast<double>(values[handle].load(std::memory_order_relaxed));
+    });
+    if (sequence == 0) {
+        return std::nullopt;
+    }
+    return sample;
+}
+
+bool SignalValueTable::snapshot(unsigned long msgId, MessageSnapshot& out) const {
+    auto found = slotOfMessage.find(msgId);
+    if (found == slotOfMessage.end()) {
+        return false;
+    }
+    const MessageSlot& slot = slots[found->second];
+    out.values.resize(slot.signalCount);
+    uint64_t sequence = readConsistent(slot, [this, &slot, &out]() {
+        out.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        for (SignalHandle i = 0; i < slot.signalCount; i++) {
+            out.values[i] = std::bit_cast<double>(values[slot.firstHandle + i].load(std::memory_order_relaxed));
+        }
+    });
+    if (sequence == 0) {
+        return false;
+    }
+    out.msgId = msgId;
+    out.updateCount = sequence / 2;
+    out.firstHandle = slot.firstHandle;
+    return true;
+}
@@ -0,0 +1,88 @@
+/*
+ *  signal_value_table.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SIGNAL_VALUE_TABLE_HPP
+#define SIGNAL_VALUE_TABLE_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include "dbc_parser.hpp"
+#include "can_log.hpp"
+
+// Latest value of one signal and the timestamp of the frame it came from
+struct SignalSample {
+    uint64_t timestamp{};
+    double value{};
+};
+
+// All signals of one message as they were stored by the same frame
+struct MessageSnapshot {
+    unsigned long msgId{};
+    uint64_t timestamp{};
+    // Frames of this message stored so far
+    uint64_t updateCount{};
+    SignalHandle firstHandle{};
+    // values[i] belongs to the signal with handle firstHandle + i. Every frame stores all
+    // signals of its message, the parser rejects multiplexed signals
+    std::vector<double> values;
+};
+
+// Latest value of every signal, in a flat array indexed by signal handle.
+// One thread decodes frames into the table with update(), without locks. Any number of
+// threads read it at the same time. Each message has a sequence number that is odd while
+// the message is being updated. Readers retry until they see the same even number before and
+// after copying, so they get all signals of a message from one frame and never block the writer
+class SignalValueTable {
+
+public:
+
+    explicit SignalValueTable(const DbcParser& dbcFile);
+    SignalValueTable(const SignalValueTable&) = delete;
+    SignalValueTable& operator=(const SignalValueTable&) = delete;
+    // Decode a frame and store its values. Must not be called from several threads at once
+    CodecStatus update(const CanFrame& frame) {
+        return update(frame.timestamp, frame.id, frame.size, frame.payload);
+    }
+    CodecStatus update(uint64_t timestamp,
+        unsigned long msgId,
+        unsigned int msgSize,
+        unsigned char const payload[]);
+    // Empty if the handle is out of range or its message has not been received yet
+    std::optional<SignalSample> getLatest(SignalHandle handle) const;
+    // Returns false if the message has no signals or has not been received yet
+    // out.values is reused, so polling the same snapshot does not allocate
+    bool snapshot(unsigned long msgId, MessageSnapshot& out) const;
+
+private:
+
+    struct alignas(64) MessageSlot {
+        // Twice the number of updates, plus one while an update is in progress
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<uint64_t> timestamp{ 0 };
+        unsigned long msgId{};
+        SignalHandle firstHandle{};
+        SignalHandle signalCount{};
+    };
+
+    const DbcParser* dbcFile;
+    std::vector<MessageSlot> slots;
+    std::vector<uint32_t> slotOfHandle;
+    std::unordered_map<unsigned long, uint32_t> slotOfMessage;
+    // Bits of the doubles, indexed by signal handle
+    std::vector<std::atomic<uint64_t> > values;
+
+    // Copy out under the sequence number of the slot. Returns the sequence number
+    // the copy is consistent with, 0 if the message has not been received yet
+    template <typename Copy>
+    uint64_t readConsistent(const MessageSlot& slot, Copy&& copy) const;
+
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ *  socketcan_reader.cpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#include "socketcan_reader.hpp"
+
+#ifdef __linux__
+
+#include <ctime>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <poll.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <linux/can/raw.h>
+
+namespace {
+
+    // Room for the receive timestamp and the drop counter of one frame
+    constexpr size_t CONTROL_BUFFER_SIZE = CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+
+    std::string systemError(const std::string& what) {
+        return what + ": " + std::strerror(errno);
+    }
+
+}
+
+SocketCanReader::SocketCanReader(const std::string& interfaceName, unsigned int batchSize) {
+    if (batchSize == 0) {
+        batchSize = 1;
+    }
+    socketFd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (socketFd < 0) {
+        throw std::invalid_argument(systemError("Could not open CAN socket"));
+    }
+    int enable = 1;
+    // Receive CAN FD frames as well as classical ones. Kernel timestamps and drop counter
+    // are delivered as control messages. Without any of them frames would come in with
+    // wrong sizes or no timestamps, so the socket is not used
+    if (setsockopt(socketFd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0
+        || setsockopt(socketFd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0
+        || setsockopt(socketFd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0) {
+        std::string error = systemError("Could not configure CAN socket");
+        close(socketFd);
+        throw std::invalid_argument(error);
+    }
+    ifreq interfaceRequest{};
+    std::strncpy(interfaceRequest.ifr_name, interfaceName.c_str(), IFNAMSIZ - 1);
+    if (ioctl(socketFd, SIOCGIFINDEX, &interfaceRequest) < 0) {
+        std::string error = systemError("Could not find CAN interface \"" + interfaceName + "\"");
+        close(socketFd);
+        throw std::invalid_argument(error);
+    }
+    sockaddr_can address{};
+    address.can_family = AF_CAN;
+    address.can_ifindex = interfaceRequest.ifr_ifindex;
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::string error = systemError("Could not bind to CAN interface \"" + interfaceName + "\"");
+        close(socketFd);
+        throw std::invalid_argument(error);
+    }
+    channel = channelFromInterfaceName(interfaceName.data(), interfaceName.data() + interfaceName.size());
+    // Set up all receive buffers once, so receiving never allocates
+    rawFrames.resize(batchSize);
+    ioVectors.resize(batchSize);
+    messages.resize(batchSize);
+    controlBuffers.resize(batchSize * CONTROL_BUFFER_SIZE);
+    frames.resize(batchSize);
+    for (unsigned int i = 0; i < batchSize; i++) {
+        ioVectors[i].iov_base = &rawFrames[i];
+        ioVectors[i].iov_len = sizeof(canfd_frame);
+        messages[i].msg_hdr.msg_iov = &ioVectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+SocketCanReader::~SocketCanReader() {
+    if (socketFd >= 0) {
+        close(socketFd);
+    }
+}
+
+size_t SocketCanReader::receiveBatch(int timeoutMs) {
+    pollfd pollRequest{};
+    pollRequest.fd = socketFd;
+    pollRequest.events = POLLIN;
+    int ready = poll(&pollRequest, 1, timeoutMs);
+    if (ready <= 0) {
+        if (ready < 0 && errno != EINTR) {
+            throw std::invalid_argument(systemError("Waiting for CAN frames failed"));
+        }
+        return 0;
+    }
+    // The kernel overwrites these fields, reset them before every call
+    for (size_t i = 0; i < messages.size(); i++) {
+        messages[i].msg_hdr.msg_control = &controlBuffers[i * CONTROL_BUFFER_SIZE];
+        messages[i].msg_hdr.msg_controllen = CONTROL_BUFFER_SIZE;
+        messages[i].msg_len = 0;
+    }
+    int received = recvmmsg(socketFd, messages.data(), static_cast<unsigned int>(messages.size()), MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            throw std::invalid_argument(systemError("Receiving CAN frames failed"));
+        }
+        return 0;
+    }
+    size_t frameCount = 0;
+    for (int i = 0; i < received; i++) {
+        const canfd_frame& raw = rawFrames[i];
+        // Skip anything that is neither a CAN nor a CAN FD frame, and error frames
+        if ((messages[i].msg_len != CAN_MTU && messages[i].msg_len != CANFD_MTU) || (raw.can_id & CAN_ERR_FLAG)) {
+            continue;
+        }
+        CanFrame& frame = frames[frameCount++];
+        frame.channel = channel;
+        // SocketCAN marks extended IDs with bit 31 as well
+        frame.id = (raw.can_id & CAN_EFF_FLAG) ? (raw.can_id & (CAN_EFF_FLAG | CAN_EFF_MASK)) : (raw.can_id & CAN_SFF_MASK);
+        frame.size = (raw.can_id & CAN_RTR_FLAG) ? 0 : raw.len;
+        std::memcpy(frame.payload, raw.data, frame.size);
+        frame.timestamp = 0;
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&messages[i].msg_hdr); cmsg != nullptr;
+            cmsg = CMSG_NXTHDR(&messages[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec stamp;
+                std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+                frame.timestamp = static_cast<uint64_t>(stamp.tv_sec) * 1000000 + stamp.tv_nsec / 1000;
+            }
+            else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                // Cumulative number of frames dropped on this socket
+                uint32_t dropCount;
+                std::memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+                statistics.framesDropped += static_cast<uint32_t>(dropCount - lastDropCount);
+                lastDropCount = dropCount;
+            }
+        }
+    }
+    statistics.framesReceived += frameCount;
+    statistics.batches++;
+    return frameCount;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,80 @@
+/*
+ *  socketcan_reader.hpp
+ *
+ *  Created on: 10/19/2026
+ *      Author: agent
+ */
+
+#ifndef SOCKETCAN_READER_HPP
+#define SOCKETCAN_READER_HPP
+
+// Live capture is only available on Linux
+#ifdef __linux__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <linux/can.h>
+#include <sys/socket.h>
+#include "can_log.hpp"
+
+struct SocketCanStatistics {
+    uint64_t framesReceived{};
+    // Number of recvmmsg calls that returned frames
+    uint64_t batches{};
+    // Frames the kernel dropped because the socket receive queue was full
+    uint64_t framesDropped{};
+};
+
+// Receives CAN and CAN FD frames from a raw SocketCAN socket (e.g. "can0" or "vcan0"),
+// many frames per system call, with kernel receive timestamps
+class SocketCanReader {
+
+public:
+
+    explicit SocketCanReader(const std::string& interfaceName, unsigned int batchSize = 64);
+    ~SocketCanReader();
+    SocketCanReader(const SocketCanReader&) = delete;
+    SocketCanReader& operator=(const SocketCanReader&) = delete;
+    // Wait up to timeoutMs (-1 waits forever) for frames and receive as many as are
+    // queued, up to the batch size. Returns the number of frames, see getFrames()
+    size_t receiveBatch(int timeoutMs = -1);
+    // Frames of the last batch, valid until the next call to receiveBatch()
+    const CanFrame* getFrames() const { return frames.data(); }
+    // Receive one batch and decode it straight away. The visitor is called as
+    // visitor(const CanFrame&, const Signal&, double physicalValue) for every decoded signal
+    // Frames that are unknown to the database are skipped. Returns the number of frames received
+    template <typename FrameSignalVisitor>
+    size_t receiveAndDecode(const DbcParser& dbcFile, FrameSignalVisitor&& visitor, int timeoutMs = -1) {
+        size_t frameCount = receiveBatch(timeoutMs);
+        for (size_t i = 0; i < frameCount; i++) {
+            const CanFrame& frame = frames[i];
+            dbcFile.tryDecodeSignals(frame.id, frame.size, frame.payload,
+                [&frame, &visitor](const Signal& sig, double value) {
+                    visitor(frame, sig, value);
+                });
+        }
+        return frameCount;
+    }
+    SocketCanStatistics getStatistics() const { return statistics; }
+    int getFileDescriptor() const { return socketFd; }
+
+private:
+
+    int socketFd = -1;
+    unsigned int channel = 0;
+    SocketCanStatistics statistics;
+    // Last value of the kernel's cumulative drop counter
+    uint32_t lastDropCount = 0;
+    // Receive buffers for recvmmsg, allocated once
+    std::vector<canfd_frame> rawFrames;
+    std::vector<iovec> ioVectors;
+    std::vector<mmsghdr> messages;
+    std::vector<char> controlBuffers;
+    std::vector<CanFrame> frames;
+
+};
+
+#endif /* __linux__ */
+
+#endif